@@ -0,0 +1,208 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <omp.h>
+
+#include "apps/bench/BenchmarkReport.hpp"
+#include "apps/common/Arguments.hpp"
+#include "apps/common/LinearSolver.hpp"
+#include "apps/common/ScalarType.hpp"
+#include "apps/common/StiffnessMatrixVariant.hpp"
+#include "apps/dirac/utils/GreensFunction.hpp"
+#include "apps/dirac/utils/L2Error.hpp"
+#include "fem/assembly/LoadVector.hpp"
+#include "fem/basis/ShapeFunctionFactory.hpp"
+#include "fem/basis/TrialFunction.hpp"
+#include "fem/domain/Mesh.hpp"
+
+using namespace fem;
+namespace fs = std::filesystem;
+
+namespace
+{
+class Stopwatch
+{
+public:
+    Stopwatch() : m_startTime(std::chrono::steady_clock::now()) {}
+
+    double elapsedSeconds() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point m_startTime;
+};
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    Arguments args(argc, argv);
+
+    const uint32_t n_max = args.getValue<int>("n");
+    const uint32_t p_max = args.getValue<int>("p");
+    const fs::path outputDirpath = fs::path(args.getValue<std::string>("output-dir"));
+    const LinearSolver::Method linearSolverMethod = args.getValue<LinearSolver::Method>("linear-solver");
+    const bool useSparseMatrices = args.getValue<bool>("sparse");
+    const ScalarType scalarType = args.getValue<ScalarType>("scalar-type");
+    const uint32_t precision = args.getValue<uint32_t>("precision");
+
+    /* The exact multi-modular solver assembles the stiffness matrix modulo its primes, so no rational one is needed */
+    const bool useModularAssembly = linearSolverMethod == LinearSolver::MultiModular && scalarType == ScalarType_Mpq;
+
+    mpf_set_default_prec(precision);
+
+    BenchmarkReport report;
+    report.setProperty("n_max", std::to_string(n_max));
+    report.setProperty("p_max", std::to_string(p_max));
+    report.setProperty("linear_solver", linearSolverMethodCliNames.at(linearSolverMethod));
+    report.setProperty("sparse", useSparseMatrices ? "true" : "false");
+    report.setProperty("scalar_type", scalarTypeCliNames.at(scalarType));
+    report.setProperty("precision", std::to_string(precision));
+    report.setProperty("omp_threads", std::to_string(omp_get_max_threads()));
+
+    /* The mesh lines are at dyadic coordinates so this point is never on a side */
+    const Vector2mpq x_0{mpq_class(1, 3), mpq_class(1, 5)};
+    const auto grad_exact = getGreensFunctionGradient(x_0);
+    LinearSolver linearSolver(linearSolverMethod);
+
+    for (const ElementType elementType : {ElementType_Triangle, ElementType_Parallelogram})
+    {
+        const std::string meshType = (elementType == ElementType_Triangle) ? "triangle" : "quadrilateral";
+        for (uint32_t n = 1; n <= n_max; n *= 2)
+        {
+            const StructuredMeshType structuredMeshType = (elementType == ElementType_Triangle) ? StructuredMeshType_Triangle : StructuredMeshType_Parallelogram;
+            const auto mesh = std::make_shared<Mesh>(createStructuredMesh(structuredMeshType, n, n, Vector2mpq(-1, -1), Vector2mpq(1, 1)));
+            for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Trunk, PolynomialSpaceType_Product})
+            {
+                std::stringstream ss;
+                ss << polynomialSpaceType;
+                const std::string polynomialSpace = ss.str();
+                std::cerr << meshType << " n=" << n << " " << polynomialSpace << std::endl;
+
+                const auto measure = [&](const std::string& stage, uint32_t p, const auto& fn)
+                {
+                    const Stopwatch stopwatch;
+                    fn();
+                    report.addMeasurement({meshType, n, polynomialSpace, p, stage, stopwatch.elapsedSeconds()});
+                };
+
+                /* The incremental solver reuses the factorization only if the systems of lower degree are leading blocks */
+                const BasisFunctionOrdering basisFunctionOrdering = linearSolverMethod == LinearSolver::IncrementalLDLT ? BasisFunctionOrdering_Hierarchical
+                                                                                                                         : BasisFunctionOrdering_Standard;
+                const FemContext ctx(mesh, p_max, polynomialSpaceType, basisFunctionOrdering);
+                ShapeFunctionFactory shapeFunctionFactory;
+                measure("createShapeFunctions", p_max, [&]()
+                {
+                    shapeFunctionFactory.createShapeFunctions(elementType, p_max);
+                });
+
+                L2ErrorCalculator l2ErrorCalculator(scalarType, shapeFunctionFactory, *mesh, x_0);
+                measure("preEvaluate", p_max, [&]()
+                {
+                    l2ErrorCalculator.preEvaluateShapeFunctions(elementType);
+                });
+
+                StiffnessMatrixVariant stiffnessMatrix;
+                if (!useModularAssembly)
+                {
+                    measure("assembleStiffnessMatrix", p_max, [&]()
+                    {
+                        stiffnessMatrix = assembleStiffnessMatrix(ctx, shapeFunctionFactory, scalarType, useSparseMatrices);
+                    });
+                }
+
+                VectorXmpq diracLoadVector;
+                measure("assembleDiracLoadVector", p_max, [&]()
+                {
+                    diracLoadVector = assembleDiracLoadVector(ctx, x_0, shapeFunctionFactory);
+                });
+
+                VectorXmpq neumannLoadVector;
+                measure("assembleNeumannLoadVector", p_max, [&]()
+                {
+                    neumannLoadVector = assembleNeumannLoadVector(ctx, grad_exact, shapeFunctionFactory);
+                });
+
+                const VectorXmpq loadVector = diracLoadVector + neumannLoadVector;
+                for (uint32_t p = 1; p <= p_max; p++)
+                {
+                    const FemContext subCtx(mesh, p, polynomialSpaceType, basisFunctionOrdering);
+
+                    StiffnessMatrixVariant A;
+                    VectorXmpq b;
+                    measure("extractSubStiffnessMatrix", p, [&]()
+                    {
+                        if (!useModularAssembly)
+                        {
+                            A = extractReducedStiffnessMatrix(ctx, stiffnessMatrix, p);
+                        }
+                        const VectorXmpq subLoadVector = extractSubLoadVector(ctx, loadVector, p);
+                        b = subLoadVector.segment(1, subLoadVector.size() - 1);
+                        if (linearSolverMethod == LinearSolver::ConjugateGradient)
+                        {
+                            linearSolver.setPreconditionerBlocks(getReducedPreconditionerBlocks(subCtx));
+                        }
+                    });
+
+                    /* With modular assembly the stiffness matrix is assembled during the solve */
+                    VectorXmpq x;
+                    measure("solve", p, [&]()
+                    {
+                        x = useModularAssembly ? solveWithModularAssembly(linearSolver, subCtx, shapeFunctionFactory, b)
+                                               : solve(linearSolver, A, b);
+                    });
+                    if (!linearSolver.isSuccessful())
+                    {
+                        std::cerr << "Warning: the linear solver failed at p=" << p << ", the solution is not reliable" << std::endl;
+                    }
+                    if (!linearSolver.hasConverged())
+                    {
+                        std::cerr << "Warning: the iterative solver did not reach the solver tolerance at p=" << p << std::endl;
+                    }
+
+                    VectorXmpq coeffs(x.size() + 1);
+                    coeffs(0) = 0;
+                    coeffs.segment(1, x.size()) = x;
+                    measure("normalizeTrialFunction", p, [&]()
+                    {
+                        normalizeTrialFunction(subCtx, coeffs, shapeFunctionFactory);
+                    });
+
+                    measure("computeL2Error", p, [&]()
+                    {
+                        mpq_class squaredL2error = 0;
+                        for (int elementIdx = 0; elementIdx < mesh->getNumOfElements(); elementIdx++)
+                        {
+                            squaredL2error += l2ErrorCalculator.computeSquaredL2ErrorOverElement(subCtx, coeffs, elementIdx);
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    if (outputDirpath.empty())
+    {
+        report.writeJson(std::cout);
+    }
+    else
+    {
+        fs::create_directories(outputDirpath);
+        const fs::path reportFilepath = outputDirpath / "benchmark.json";
+        std::ofstream ofs(reportFilepath);
+        if (!ofs.is_open())
+        {
+            std::cout << "Failed to create output file " << reportFilepath << std::endl;
+            return 1;
+        }
+        report.writeJson(ofs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "apps/bench/BenchmarkReport.hpp"
+
+#include <iomanip>
+
+namespace fem
+{
+namespace
+{
+/* Only the characters that can appear in the names used by the benchmarks are escaped */
+std::string quote(const std::string& str)
+{
+    std::string res = "\"";
+    for (const char c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            res += '\\';
+        }
+        res += c;
+    }
+    res += '"';
+    return res;
+}
+} // namespace
+
+void BenchmarkReport::writeJson(std::ostream& out) const
+{
+    out << "{" << std::endl;
+    out << "  \"properties\": {";
+    for (auto it = m_properties.begin(); it != m_properties.end(); it++)
+    {
+        out << (it == m_properties.begin() ? "" : ",") << std::endl;
+        out << "    " << quote(it->first) << ": " << quote(it->second);
+    }
+    out << std::endl << "  }," << std::endl;
+    out << "  \"measurements\": [";
+    for (int i = 0; i < m_measurements.size(); i++)
+    {
+        const Measurement& m = m_measurements[i];
+        out << (i == 0 ? "" : ",") << std::endl;
+        out << "    {\"mesh\": " << quote(m.meshType)
+            << ", \"n\": " << m.n
+            << ", \"polynomial_space\": " << quote(m.polynomialSpace)
+            << ", \"p\": " << m.p
+            << ", \"stage\": " << quote(m.stage)
+            << ", \"seconds\": " << std::setprecision(9) << m.seconds << "}";
+    }
+    out << std::endl << "  ]" << std::endl;
+    out << "}" << std::endl;
+}
+} // namespace fem
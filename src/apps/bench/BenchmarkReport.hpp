@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace fem
+{
+class BenchmarkReport
+{
+public:
+    struct Measurement
+    {
+        std::string meshType;
+        uint32_t n;
+        std::string polynomialSpace;
+        uint32_t p;
+        std::string stage;
+        double seconds;
+    };
+
+public:
+    BenchmarkReport() = default;
+
+    void setProperty(const std::string& key, const std::string& value) { m_properties[key] = value; }
+    void addMeasurement(const Measurement& measurement) { m_measurements.push_back(measurement); }
+    void writeJson(std::ostream& out) const;
+
+private:
+    std::map<std::string, std::string> m_properties;
+    std::vector<Measurement> m_measurements;
+};
+} // namespace fem
@@ -4,7 +4,10 @@
 #include <iostream>
 
 #include "apps/common/LinearSolver.hpp"
+#include "apps/common/ScalarType.hpp"
+#include "fem/basis/BasisFunctionOrdering.hpp"
 #include "fem/basis/PolynomialSpaceType.hpp"
+#include "fem/domain/Mesh.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
@@ -19,7 +22,12 @@ Arguments::Arguments(int argc, char* argv[])
 {
     m_desc.add_options()
         ("mesh-file", po::value<std::string>())
+        ("structured-mesh", po::value<std::string>())
+        ("nx", po::value<int>())
+        ("ny", po::value<int>())
+        ("rectangle", po::value<std::vector<std::string>>()->multitoken())
         ("p", po::value<int>())
+        ("n", po::value<int>())
         ("polynomial-space", po::value<std::string>())
         ("variable-name", po::value<std::string>())
         ("dirac-point", po::value<std::vector<std::string>>()->multitoken())
@@ -29,6 +37,14 @@ Arguments::Arguments(int argc, char* argv[])
         ("output-dir", po::value<std::string>()->default_value(""))
         ("precision", po::value<int>()->default_value(64))
         ("linear-solver", po::value<std::string>()->default_value("ldlt"))
+        ("sparse", po::bool_switch())
+        ("scalar-type", po::value<std::string>()->default_value("mpq"))
+        ("incremental", po::bool_switch())
+        ("hierarchical-ordering", po::bool_switch())
+        ("static-condensation", po::bool_switch())
+        ("matrix-free", po::bool_switch())
+        ("solver-tolerance", po::value<double>()->default_value(1e-12))
+        ("l2-error-tolerance", po::value<double>()->default_value(0))
         ;
 
     po::store(po::parse_command_line(argc, argv, m_desc, po::command_line_style::unix_style ^ po::command_line_style::allow_short), m_vm);
@@ -46,6 +62,90 @@ Arguments::Arguments(int argc, char* argv[])
         }
     });
 
+    m_optionParsers.emplace("structured-mesh", [](const po::variables_map& vm)
+    {
+        if (vm.count("structured-mesh"))
+        {
+            const std::string str = vm["structured-mesh"].as<std::string>();
+            if (str == "triangle")
+            {
+                return std::any(StructuredMeshType_Triangle);
+            }
+            else if (str == "parallelogram")
+            {
+                return std::any(StructuredMeshType_Parallelogram);
+            }
+            else if (str == "mixed")
+            {
+                return std::any(StructuredMeshType_Mixed);
+            }
+            else
+            {
+                std::cout << "Invalid structured mesh type: " << str << std::endl;
+                return std::any();
+            }
+        }
+        else
+        {
+            ARGUMENT_MISSING("structured-mesh");
+        }
+    });
+
+    for (const std::string option : {"nx", "ny"})
+    {
+        m_optionParsers.emplace(option, [option](const po::variables_map& vm)
+        {
+            if (vm.count(option))
+            {
+                const int numOfCells = vm[option].as<int>();
+                if (numOfCells >= 1)
+                {
+                    return std::any(static_cast<uint32_t>(numOfCells));
+                }
+                else
+                {
+                    std::cout << option << " must be greater than or equal to 1" << std::endl;
+                    return std::any();
+                }
+            }
+            else
+            {
+                ARGUMENT_MISSING(option);
+            }
+        });
+    }
+
+    /* Returns the lower left and upper right corners, [-1,1]^2 if not given */
+    m_optionParsers.emplace("rectangle", [](const po::variables_map& vm)
+    {
+        if (vm.count("rectangle"))
+        {
+            const std::vector<std::string> coords = vm["rectangle"].as<std::vector<std::string>>();
+            if (coords.size() != 4)
+            {
+                std::cout << "Rectangle must contain four coordinate values: xmin ymin xmax ymax" << std::endl;
+                return std::any();
+            }
+            Vector2mpq lowerLeft{mpq_class(coords[0]), mpq_class(coords[1])};
+            Vector2mpq upperRight{mpq_class(coords[2]), mpq_class(coords[3])};
+            for (int i = 0; i < 2; i++)
+            {
+                lowerLeft(i).canonicalize();
+                upperRight(i).canonicalize();
+            }
+            if (lowerLeft(0) >= upperRight(0) || lowerLeft(1) >= upperRight(1))
+            {
+                std::cout << "Rectangle must have a positive width and height" << std::endl;
+                return std::any();
+            }
+            return std::any(std::make_pair(lowerLeft, upperRight));
+        }
+        else
+        {
+            return std::any(std::make_pair(Vector2mpq(-1, -1), Vector2mpq(1, 1)));
+        }
+    });
+
     m_optionParsers.emplace("p", [](const po::variables_map& vm)
     {
         if (vm.count("p"))
@@ -67,6 +167,27 @@ Arguments::Arguments(int argc, char* argv[])
         }
     });
 
+    m_optionParsers.emplace("n", [](const po::variables_map& vm)
+    {
+        if (vm.count("n"))
+        {
+            const int n = vm["n"].as<int>();
+            if (n >= 1)
+            {
+                return std::any(n);
+            }
+            else
+            {
+                std::cout << "n must be greater than or equal to 1" << std::endl;
+                return std::any();
+            }
+        }
+        else
+        {
+            ARGUMENT_MISSING("n");
+        }
+    });
+
     m_optionParsers.emplace("polynomial-space", [](const po::variables_map& vm)
     {
         if (vm.count("polynomial-space"))
@@ -242,5 +363,99 @@ Arguments::Arguments(int argc, char* argv[])
             ARGUMENT_MISSING("linear-solver");
         }
     });
+
+    m_optionParsers.emplace("sparse", [](const po::variables_map& vm)
+    {
+        return std::any(vm["sparse"].as<bool>());
+    });
+
+    m_optionParsers.emplace("scalar-type", [](const po::variables_map& vm)
+    {
+        if (vm.count("scalar-type"))
+        {
+            const std::string scalarType = vm["scalar-type"].as<std::string>();
+            const auto it = std::find_if(scalarTypeCliNames.begin(), scalarTypeCliNames.end(),
+                [&scalarType](const auto& elem)
+                {
+                    return elem.second == scalarType;
+                }
+            );
+            if (it != scalarTypeCliNames.end())
+            {
+                return std::any(it->first);
+            }
+            else
+            {
+                std::cout << "Invalid scalar type: " << scalarType << std::endl;
+                return std::any();
+            }
+        }
+        else
+        {
+            ARGUMENT_MISSING("scalar-type");
+        }
+    });
+
+    m_optionParsers.emplace("incremental", [](const po::variables_map& vm)
+    {
+        return std::any(vm["incremental"].as<bool>());
+    });
+
+    m_optionParsers.emplace("hierarchical-ordering", [](const po::variables_map& vm)
+    {
+        return std::any(vm["hierarchical-ordering"].as<bool>() ? BasisFunctionOrdering_Hierarchical : BasisFunctionOrdering_Standard);
+    });
+
+    m_optionParsers.emplace("static-condensation", [](const po::variables_map& vm)
+    {
+        return std::any(vm["static-condensation"].as<bool>());
+    });
+
+    m_optionParsers.emplace("matrix-free", [](const po::variables_map& vm)
+    {
+        return std::any(vm["matrix-free"].as<bool>());
+    });
+
+    m_optionParsers.emplace("solver-tolerance", [](const po::variables_map& vm)
+    {
+        if (vm.count("solver-tolerance"))
+        {
+            const double tolerance = vm["solver-tolerance"].as<double>();
+            if (tolerance > 0)
+            {
+                return std::any(tolerance);
+            }
+            else
+            {
+                std::cout << "solver-tolerance must be positive" << std::endl;
+                return std::any();
+            }
+        }
+        else
+        {
+            ARGUMENT_MISSING("solver-tolerance");
+        }
+    });
+
+    m_optionParsers.emplace("l2-error-tolerance", [](const po::variables_map& vm)
+    {
+        if (vm.count("l2-error-tolerance"))
+        {
+            const double tolerance = vm["l2-error-tolerance"].as<double>();
+            if (tolerance >= 0)
+            {
+                return std::any(tolerance);
+            }
+            else
+            {
+                std::cout << "l2-error-tolerance must be non-negative" << std::endl;
+                return std::any();
+            }
+        }
+        else
+        {
+            ARGUMENT_MISSING("l2-error-tolerance");
+        }
+    });
 }
 } // namespace fem
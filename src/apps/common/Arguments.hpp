@@ -26,6 +26,11 @@ public:
         return std::any_cast<T>(value);
     }
 
+    bool hasValue(const std::string& option) const
+    {
+        return m_vm.count(option) > 0 && !m_vm[option].defaulted();
+    }
+
 private:
     using OptionParserFn = std::function<std::any(const boost::program_options::variables_map&)>;
 
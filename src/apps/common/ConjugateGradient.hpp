@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+namespace fem
+{
+/*
+ * Block-Jacobi preconditioner: the diagonal blocks of A on the given groups of unknowns are factorized and inverted
+ * independently. Unknowns not in any group form 1x1 blocks.
+ */
+template<typename Scalar>
+class BlockJacobiPreconditioner
+{
+public:
+    /* A is a dense or sparse matrix or an operator providing getDiagonalBlocks(blocks) */
+    template<typename MatrixType>
+    BlockJacobiPreconditioner(const MatrixType& A, const std::vector<std::vector<uint32_t>>& blocks)
+    {
+        const uint32_t dim = A.rows();
+        std::vector<bool> isInBlock(dim, false);
+        for (const auto& block : blocks)
+        {
+            for (uint32_t i : block)
+            {
+                assert(i < dim && !isInBlock[i]);
+                isInBlock[i] = true;
+            }
+            m_blocks.push_back(block);
+        }
+        for (uint32_t i = 0; i < dim; i++)
+        {
+            if (!isInBlock[i])
+            {
+                m_blocks.push_back({i});
+            }
+        }
+        const std::vector<Eigen::MatrixX<Scalar>> blockMatrices = getDiagonalBlocks(A, m_blocks);
+        m_blockFactorizations.resize(m_blocks.size());
+        #pragma omp parallel for schedule(dynamic)
+        for (int blockIdx = 0; blockIdx < m_blocks.size(); blockIdx++)
+        {
+            m_blockFactorizations[blockIdx].compute(blockMatrices[blockIdx]);
+        }
+    }
+
+    Eigen::VectorX<Scalar> solve(const Eigen::VectorX<Scalar>& r) const
+    {
+        Eigen::VectorX<Scalar> res(r.size());
+        for (int blockIdx = 0; blockIdx < m_blocks.size(); blockIdx++)
+        {
+            const Eigen::VectorX<Scalar> blockSolution = m_blockFactorizations[blockIdx].solve(Eigen::VectorX<Scalar>(r(m_blocks[blockIdx])));
+            res(m_blocks[blockIdx]) = blockSolution;
+        }
+        return res;
+    }
+
+private:
+    template<typename OperatorType>
+    static std::vector<Eigen::MatrixX<Scalar>> getDiagonalBlocks(const OperatorType& A, const std::vector<std::vector<uint32_t>>& blocks)
+    {
+        return A.getDiagonalBlocks(blocks);
+    }
+
+    static std::vector<Eigen::MatrixX<Scalar>> getDiagonalBlocks(const Eigen::MatrixX<Scalar>& A, const std::vector<std::vector<uint32_t>>& blocks)
+    {
+        std::vector<Eigen::MatrixX<Scalar>> res;
+        for (const auto& block : blocks)
+        {
+            res.push_back(A(block, block));
+        }
+        return res;
+    }
+
+    static std::vector<Eigen::MatrixX<Scalar>> getDiagonalBlocks(const Eigen::SparseMatrix<Scalar>& A, const std::vector<std::vector<uint32_t>>& blocks)
+    {
+        std::vector<Eigen::MatrixX<Scalar>> res;
+        for (const auto& block : blocks)
+        {
+            Eigen::MatrixX<Scalar> blockMatrix(block.size(), block.size());
+            for (int j = 0; j < block.size(); j++)
+            {
+                for (int i = 0; i < block.size(); i++)
+                {
+                    blockMatrix(i, j) = A.coeff(block[i], block[j]);
+                }
+            }
+            res.push_back(std::move(blockMatrix));
+        }
+        return res;
+    }
+
+private:
+    std::vector<std::vector<uint32_t>> m_blocks;
+    std::vector<Eigen::LDLT<Eigen::MatrixX<Scalar>>> m_blockFactorizations;
+};
+
+/*
+ * Preconditioned conjugate gradient method for a symmetric positive definite A. Only the product A*x is used, so A
+ * may be a dense or sparse matrix or any operator providing it. Iterates until ||b - A*x|| <= tolerance * ||b|| or
+ * until the maximum number of iterations, after which hasConverged tells which of the two happened.
+ */
+template<typename Scalar>
+class ConjugateGradient
+{
+public:
+    ConjugateGradient(double tolerance, uint32_t maxNumOfIterations)
+        : m_tolerance(tolerance)
+        , m_maxNumOfIterations(maxNumOfIterations)
+        , m_numOfIterations(0)
+        , m_converged(false)
+    {
+    }
+
+    template<typename OperatorType, typename Preconditioner>
+    Eigen::VectorX<Scalar> solve(const OperatorType& A, const Eigen::VectorX<Scalar>& b, const Preconditioner& preconditioner)
+    {
+        const Scalar tolerance = m_tolerance;
+        const Scalar threshold = tolerance * tolerance * b.squaredNorm();
+        Eigen::VectorX<Scalar> x = Eigen::VectorX<Scalar>::Zero(b.size());
+        Eigen::VectorX<Scalar> r = b;
+        Eigen::VectorX<Scalar> z = preconditioner.solve(r);
+        Eigen::VectorX<Scalar> d = z;
+        Scalar rz = r.dot(z);
+        m_numOfIterations = 0;
+        while (r.squaredNorm() > threshold && m_numOfIterations < m_maxNumOfIterations)
+        {
+            const Eigen::VectorX<Scalar> Ad = A * d;
+            const Scalar alpha = rz / d.dot(Ad);
+            x += alpha * d;
+            r -= alpha * Ad;
+            z = preconditioner.solve(r);
+            const Scalar rzNew = r.dot(z);
+            d = z + (rzNew / rz) * d;
+            rz = rzNew;
+            m_numOfIterations++;
+        }
+        m_converged = r.squaredNorm() <= threshold;
+        return x;
+    }
+
+    uint32_t getNumOfIterations() const { return m_numOfIterations; }
+    /* False if the latest solve stopped at the maximum number of iterations before reaching the tolerance */
+    bool hasConverged() const { return m_converged; }
+
+private:
+    double m_tolerance;
+    uint32_t m_maxNumOfIterations;
+    uint32_t m_numOfIterations;
+    bool m_converged;
+};
+} // namespace fem
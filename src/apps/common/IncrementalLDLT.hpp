@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cassert>
+
+#include <Eigen/Dense>
+
+namespace fem
+{
+/*
+ * Unpivoted LDL^T factorization A = L*D*L^T of a symmetric positive definite matrix which can be extended when the
+ * matrix grows. If the previously factorized matrix is the leading principal block of the new one, only the new rows
+ * are computed with the bordered update
+ *     L_21 = (D^-1 * L^-1 * A_12)^T,  L_22*D_22*L_22^T = A_22 - L_21*D*L_21^T
+ * so that factorizing a sequence of nested systems costs about as much as factorizing the largest one. Otherwise the
+ * matrix is factorized from scratch. A pivot which is not positive stops the factorization with info() set to
+ * Eigen::NumericalIssue and drops the factor, so the next matrix is factorized from scratch.
+ */
+template<typename Scalar>
+class IncrementalLDLT
+{
+public:
+    IncrementalLDLT& compute(const Eigen::MatrixX<Scalar>& A)
+    {
+        assert(A.rows() == A.cols());
+        const int n = isLeadingBlockOf(A) ? m_A.rows() : 0;
+        const int m = A.rows() - n;
+        m_L.conservativeResize(A.rows(), A.rows());
+        m_D.conservativeResize(A.rows());
+        m_L.topRightCorner(n, m).setZero();
+
+        Eigen::MatrixX<Scalar> S = A.bottomRightCorner(m, m);
+        if (n > 0)
+        {
+            const Eigen::MatrixX<Scalar> W = m_L.topLeftCorner(n, n).template triangularView<Eigen::UnitLower>().solve(A.topRightCorner(n, m));
+            const Eigen::MatrixX<Scalar> L_21 = W.transpose() * m_D.head(n).cwiseInverse().asDiagonal();
+            S -= L_21 * W;
+            m_L.bottomLeftCorner(m, n) = L_21;
+        }
+        if (factorizeBlock(S))
+        {
+            m_A = A;
+            m_info = Eigen::Success;
+        }
+        else
+        {
+            m_A.resize(0, 0);
+            m_L.resize(0, 0);
+            m_D.resize(0);
+            m_info = Eigen::NumericalIssue;
+        }
+        return *this;
+    }
+
+    Eigen::ComputationInfo info() const { return m_info; }
+
+    Eigen::VectorX<Scalar> solve(const Eigen::VectorX<Scalar>& b) const
+    {
+        assert(m_info == Eigen::Success && b.size() == m_L.rows());
+        Eigen::VectorX<Scalar> x = m_L.template triangularView<Eigen::UnitLower>().solve(b);
+        x = x.cwiseQuotient(m_D);
+        m_L.transpose().template triangularView<Eigen::UnitUpper>().solveInPlace(x);
+        return x;
+    }
+
+private:
+    bool isLeadingBlockOf(const Eigen::MatrixX<Scalar>& A) const
+    {
+        const int n = m_A.rows();
+        return n > 0 && n <= A.rows() && A.topLeftCorner(n, n) == m_A;
+    }
+
+    /* Factorizes the Schur complement S into the trailing block of L and D, false if a pivot is not positive */
+    bool factorizeBlock(const Eigen::MatrixX<Scalar>& S)
+    {
+        const int m = S.rows();
+        auto L = m_L.bottomRightCorner(m, m);
+        auto D = m_D.tail(m);
+        L.setIdentity();
+        for (int j = 0; j < m; j++)
+        {
+            const Eigen::VectorX<Scalar> v = L.row(j).head(j).transpose().cwiseProduct(D.head(j));
+            D(j) = S(j, j) - L.row(j).head(j).dot(v);
+            if (!(D(j) > 0))
+            {
+                return false;
+            }
+            const int k = m-j-1;
+            L.col(j).tail(k) = (S.col(j).tail(k) - L.bottomLeftCorner(k, j) * v) / D(j);
+        }
+        return true;
+    }
+
+private:
+    Eigen::MatrixX<Scalar> m_A;
+    Eigen::MatrixX<Scalar> m_L;
+    Eigen::VectorX<Scalar> m_D;
+    Eigen::ComputationInfo m_info = Eigen::Success;
+};
+} // namespace fem
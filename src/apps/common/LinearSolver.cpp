@@ -1,65 +1,395 @@
 #include "apps/common/LinearSolver.hpp"
 
 #include <cassert>
+#include <optional>
 
 #include <Eigen/Dense>
+#include <Eigen/OrderingMethods>
+#include <Eigen/SparseCholesky>
+#include <Eigen/SparseLU>
+#include <Eigen/SparseQR>
+
+#include "apps/common/ConjugateGradient.hpp"
+#include "apps/common/IncrementalLDLT.hpp"
+#include "fem/assembly/StiffnessMatrix.hpp"
+#include "fem/multiprecision/FractionFreeSolver.hpp"
+#include "fem/multiprecision/MultiModularSolver.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
 namespace
 {
-mpf_class computeRelativeError(const MatrixXmpq& A, const VectorXmpq& x, const VectorXmpq& b)
+template<typename MatrixType>
+mpf_class computeRelativeError(const MatrixType& A, const VectorXmpq& x, const VectorXmpq& b)
 {
     const VectorXmpq err = A*x - b;
     return sqrt(mpf_class(err.squaredNorm())) / sqrt(mpf_class(b.squaredNorm()));
 }
+
+template<typename MatrixType, typename Scalar>
+mpf_class computeRelativeError(const MatrixType& A, const Eigen::VectorX<Scalar>& x, const Eigen::VectorX<Scalar>& b)
+{
+    const Scalar relativeError = (A*x - b).norm() / b.norm();
+    return mpf_class(convertToRational(relativeError));
+}
+
+/* success is set to false if the factorization fails, LLT and LDLT being the ones that report it */
+template<typename Scalar>
+Eigen::VectorX<Scalar> solveInScalar(LinearSolver::Method method, const Eigen::MatrixX<Scalar>& A, const Eigen::VectorX<Scalar>& b, bool& success)
+{
+    success = true;
+    if (method == LinearSolver::PartialPivLU)
+    {
+        return A.partialPivLu().solve(b);
+    }
+    else if (method == LinearSolver::ColPivHouseholderQR)
+    {
+        return A.colPivHouseholderQr().solve(b);
+    }
+    else if (method == LinearSolver::LLT)
+    {
+        const Eigen::LLT<Eigen::MatrixX<Scalar>> solver(A);
+        success = solver.info() == Eigen::Success;
+        return solver.solve(b);
+    }
+    else if (method == LinearSolver::LDLT)
+    {
+        const Eigen::LDLT<Eigen::MatrixX<Scalar>> solver(A);
+        success = solver.info() == Eigen::Success;
+        return solver.solve(b);
+    }
+    else if (method == LinearSolver::BDCSVD)
+    {
+        return A.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b);
+    }
+    else if (method == LinearSolver::FullPivLU)
+    {
+        return A.fullPivLu().solve(b);
+    }
+    else
+    {
+        assert(false && "Unknown method");
+        return Eigen::VectorX<Scalar>();
+    }
+}
+
+/* Methods without a sparse counterpart (FullPivLU, BDCSVD) fall back to the dense solver. success is set to false if
+ * the factorization fails. */
+template<typename Scalar>
+Eigen::VectorX<Scalar> solveInScalar(LinearSolver::Method method, const Eigen::SparseMatrix<Scalar>& A, const Eigen::VectorX<Scalar>& b, bool& success)
+{
+    if (method == LinearSolver::PartialPivLU)
+    {
+        Eigen::SparseLU<Eigen::SparseMatrix<Scalar>> solver(A);
+        success = solver.info() == Eigen::Success;
+        return success ? Eigen::VectorX<Scalar>(solver.solve(b)) : Eigen::VectorX<Scalar>::Zero(b.size());
+    }
+    else if (method == LinearSolver::ColPivHouseholderQR)
+    {
+        Eigen::SparseMatrix<Scalar> A_c = A;
+        A_c.makeCompressed();
+        Eigen::SparseQR<Eigen::SparseMatrix<Scalar>, Eigen::COLAMDOrdering<int>> solver(A_c);
+        success = solver.info() == Eigen::Success;
+        return success ? Eigen::VectorX<Scalar>(solver.solve(b)) : Eigen::VectorX<Scalar>::Zero(b.size());
+    }
+    else if (method == LinearSolver::LLT)
+    {
+        Eigen::SimplicialLLT<Eigen::SparseMatrix<Scalar>> solver(A);
+        success = solver.info() == Eigen::Success;
+        return success ? Eigen::VectorX<Scalar>(solver.solve(b)) : Eigen::VectorX<Scalar>::Zero(b.size());
+    }
+    else if (method == LinearSolver::LDLT)
+    {
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<Scalar>> solver(A);
+        success = solver.info() == Eigen::Success;
+        return success ? Eigen::VectorX<Scalar>(solver.solve(b)) : Eigen::VectorX<Scalar>::Zero(b.size());
+    }
+    else
+    {
+        return solveInScalar(method, Eigen::MatrixX<Scalar>(A), b, success);
+    }
+}
+
+inline double convertToDouble(const mpq_class& x) { return x.get_d(); }
+inline double convertToDouble(const mpf_class& x) { return x.get_d(); }
+inline double convertToDouble(double x) { return x; }
+inline double convertToDouble(long double x) { return static_cast<double>(x); }
+
+/* Stops when the relative residual is at most tolerance, which sets converged, or when it no longer decreases */
+template<typename MatrixType, typename Scalar, typename Factorization>
+Eigen::VectorX<Scalar> refineIteratively(const MatrixType& A, const Eigen::VectorX<Scalar>& b, const Factorization& factorization, double tolerance,
+                                         uint32_t& numOfIterations, bool& converged)
+{
+    const uint32_t maxNumOfIterations = 100;
+    const Scalar threshold = Scalar(tolerance) * Scalar(tolerance) * b.squaredNorm();
+    Eigen::VectorX<Scalar> x = Eigen::VectorX<Scalar>::Zero(b.size());
+    Eigen::VectorX<Scalar> r = b;
+    Scalar squaredResidualNorm = r.squaredNorm();
+    numOfIterations = 0;
+    while (squaredResidualNorm > threshold && numOfIterations < maxNumOfIterations)
+    {
+        const Eigen::VectorXd correction = factorization.solve(r.unaryExpr([](const Scalar& elem) { return convertToDouble(elem); }));
+        const Eigen::VectorX<Scalar> x_new = x + correction.unaryExpr([](double elem) { return Scalar(elem); });
+        const Eigen::VectorX<Scalar> r_new = b - A*x_new;
+        const Scalar squaredResidualNormNew = r_new.squaredNorm();
+        if (squaredResidualNormNew >= squaredResidualNorm)
+        {
+            break;
+        }
+        x = x_new;
+        r = r_new;
+        squaredResidualNorm = squaredResidualNormNew;
+        numOfIterations++;
+    }
+    converged = squaredResidualNorm <= threshold;
+    return x;
+}
+
+/* The solution of an exact solver, or zero if it failed */
+VectorXmpq getSolution(const std::optional<VectorXmpq>& x, Eigen::Index size, bool& success)
+{
+    success = x.has_value();
+    return success ? *x : VectorXmpq(VectorXmpq::Zero(size));
+}
+
+template<typename Scalar>
+Eigen::VectorX<Scalar> convertRationalVector(const VectorXmpq& v)
+{
+    return v.unaryExpr([](const mpq_class& elem) { return convertRational<Scalar>(elem); });
+}
+
+template<typename Scalar>
+VectorXmpq convertVectorToRational(const Eigen::VectorX<Scalar>& v)
+{
+    return v.unaryExpr([](const Scalar& elem) { return convertToRational(elem); });
+}
 } // namespace
 
 LinearSolver::LinearSolver(Method method)
     : m_method(method)
     , m_relativeError(-1)
+    , m_tolerance(1e-12)
+    , m_numOfIterations(0)
+    , m_success(true)
+    , m_converged(true)
+{
+}
+
+template<typename Scalar>
+Eigen::VectorX<Scalar> LinearSolver::solveInScalar(const Eigen::MatrixX<Scalar>& A, const Eigen::VectorX<Scalar>& b)
+{
+    if (m_method == IncrementalLDLT)
+    {
+        if (m_incrementalLDLT.type() != typeid(fem::IncrementalLDLT<Scalar>))
+        {
+            m_incrementalLDLT = fem::IncrementalLDLT<Scalar>();
+        }
+        auto& ldlt = std::any_cast<fem::IncrementalLDLT<Scalar>&>(m_incrementalLDLT);
+        m_success = ldlt.compute(A).info() == Eigen::Success;
+        if (!m_success)
+        {
+            return Eigen::VectorX<Scalar>::Zero(b.size());
+        }
+        return ldlt.solve(b);
+    }
+    else if (m_method == ConjugateGradient)
+    {
+        return solveIteratively(A, b);
+    }
+    else if (m_method == IterativeRefinement)
+    {
+        return refineIteratively(A, b);
+    }
+    else if (m_method == FractionFree)
+    {
+        const MatrixXmpq A_q = A.unaryExpr([](const Scalar& elem) { return convertToRational(elem); });
+        return convertRationalVector<Scalar>(getSolution(solveFractionFree(A_q, convertVectorToRational(b)), b.size(), m_success));
+    }
+    else if (m_method == MultiModular)
+    {
+        const MatrixXmpq A_q = A.unaryExpr([](const Scalar& elem) { return convertToRational(elem); });
+        return convertRationalVector<Scalar>(getSolution(solveMultiModular(A_q, convertVectorToRational(b)), b.size(), m_success));
+    }
+    return fem::solveInScalar(m_method, A, b, m_success);
+}
+
+template<typename Scalar>
+Eigen::VectorX<Scalar> LinearSolver::solveInScalar(const Eigen::SparseMatrix<Scalar>& A, const Eigen::VectorX<Scalar>& b)
+{
+    if (m_method == IncrementalLDLT)
+    {
+        return solveInScalar(Eigen::MatrixX<Scalar>(A), b);
+    }
+    else if (m_method == ConjugateGradient)
+    {
+        return solveIteratively(A, b);
+    }
+    else if (m_method == IterativeRefinement)
+    {
+        return refineIteratively(A, b);
+    }
+    else if (m_method == FractionFree)
+    {
+        const SparseMatrixXmpq A_q = A.unaryExpr([](const Scalar& elem) { return convertToRational(elem); });
+        return convertRationalVector<Scalar>(getSolution(solveFractionFree(A_q, convertVectorToRational(b)), b.size(), m_success));
+    }
+    else if (m_method == MultiModular)
+    {
+        const SparseMatrixXmpq A_q = A.unaryExpr([](const Scalar& elem) { return convertToRational(elem); });
+        return convertRationalVector<Scalar>(getSolution(solveMultiModular(A_q, convertVectorToRational(b)), b.size(), m_success));
+    }
+    return fem::solveInScalar(m_method, A, b, m_success);
+}
+
+template<typename MatrixType, typename Scalar>
+Eigen::VectorX<Scalar> LinearSolver::solveIteratively(const MatrixType& A, const Eigen::VectorX<Scalar>& b)
 {
+    const BlockJacobiPreconditioner<Scalar> preconditioner(A, m_preconditionerBlocks);
+    fem::ConjugateGradient<Scalar> conjugateGradient(m_tolerance, 10 * A.rows());
+    const Eigen::VectorX<Scalar> x = conjugateGradient.solve(A, b, preconditioner);
+    m_numOfIterations = conjugateGradient.getNumOfIterations();
+    m_converged = conjugateGradient.hasConverged();
+    return x;
+}
+
+template<typename Scalar>
+Eigen::VectorX<Scalar> LinearSolver::refineIteratively(const Eigen::MatrixX<Scalar>& A, const Eigen::VectorX<Scalar>& b)
+{
+    const Eigen::MatrixXd A_d = A.unaryExpr([](const Scalar& elem) { return convertToDouble(elem); });
+    const Eigen::LDLT<Eigen::MatrixXd> ldlt(A_d);
+    m_success = ldlt.info() == Eigen::Success;
+    if (!m_success)
+    {
+        m_numOfIterations = 0;
+        return Eigen::VectorX<Scalar>::Zero(b.size());
+    }
+    return fem::refineIteratively(A, b, ldlt, m_tolerance, m_numOfIterations, m_converged);
+}
+
+template<typename Scalar>
+Eigen::VectorX<Scalar> LinearSolver::refineIteratively(const Eigen::SparseMatrix<Scalar>& A, const Eigen::VectorX<Scalar>& b)
+{
+    const Eigen::SparseMatrix<double> A_d = A.unaryExpr([](const Scalar& elem) { return convertToDouble(elem); });
+    const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> ldlt(A_d);
+    m_success = ldlt.info() == Eigen::Success;
+    if (!m_success)
+    {
+        m_numOfIterations = 0;
+        return Eigen::VectorX<Scalar>::Zero(b.size());
+    }
+    return fem::refineIteratively(A, b, ldlt, m_tolerance, m_numOfIterations, m_converged);
 }
 
 VectorXmpq LinearSolver::solve(const MatrixXmpq& A, const VectorXmpq& b)
 {
+    m_success = true;
+    m_converged = true;
     VectorXmpq res;
-    const Eigen::MatrixXd A_d = A.unaryExpr([](const mpq_class& elem) -> double { return elem.get_d(); });
-    const Eigen::VectorXd b_d = b.unaryExpr([](const mpq_class& elem) -> double { return elem.get_d(); });
     if (m_method == PartialPivLU)
     {
         res = A.partialPivLu().solve(b); // becomes extremely slow very quickly so use mainly for validation etc.
     }
-    else if (m_method == ColPivHouseholderQR)
+    else if (m_method == IterativeRefinement)
+    {
+        res = refineIteratively(A, b);
+    }
+    else if (m_method == FractionFree)
+    {
+        res = getSolution(solveFractionFree(A, b), b.size(), m_success);
+    }
+    else if (m_method == MultiModular)
+    {
+        res = getSolution(solveMultiModular(A, b), b.size(), m_success);
+    }
+    else
     {
-        const Eigen::VectorXd x_d = A_d.colPivHouseholderQr().solve(b_d);
-        res = x_d.cast<mpq_class>();
+        const Eigen::MatrixXd A_d = A.unaryExpr([](const mpq_class& elem) -> double { return elem.get_d(); });
+        res = convertVectorToRational(solveInScalar(A_d, convertRationalVector<double>(b)));
     }
-    else if (m_method == LLT)
+    m_relativeError = computeRelativeError(A, res, b);
+    return res;
+}
+
+VectorXmpq LinearSolver::solve(const SparseMatrixXmpq& A, const VectorXmpq& b)
+{
+    m_success = true;
+    m_converged = true;
+    VectorXmpq res;
+    if (m_method == PartialPivLU)
     {
-        const Eigen::VectorXd x_d = A_d.llt().solve(b_d);
-        res = x_d.cast<mpq_class>();
+        res = MatrixXmpq(A).partialPivLu().solve(b); // exact as for dense matrices, Eigen's SparseLU needs a real scalar
     }
-    else if (m_method == LDLT)
+    else if (m_method == IterativeRefinement)
     {
-        const Eigen::VectorXd x_d = A_d.ldlt().solve(b_d);
-        res = x_d.cast<mpq_class>();
+        res = refineIteratively(A, b);
     }
-    else if (m_method == BDCSVD)
+    else if (m_method == FractionFree)
     {
-        const Eigen::VectorXd x_d = A_d.bdcSvd(Eigen::ComputeThinU | Eigen::ComputeThinV).solve(b_d);
-        res = x_d.cast<mpq_class>();
+        res = getSolution(solveFractionFree(A, b), b.size(), m_success);
     }
-    else if (m_method == FullPivLU)
+    else if (m_method == MultiModular)
     {
-        const Eigen::VectorXd x_d = A_d.fullPivLu().solve(b_d);
-        res = x_d.cast<mpq_class>();
+        res = getSolution(solveMultiModular(A, b), b.size(), m_success);
     }
     else
     {
-        assert(false && "Unknown method");
+        const Eigen::SparseMatrix<double> A_d = A.unaryExpr([](const mpq_class& elem) -> double { return elem.get_d(); });
+        res = convertVectorToRational(solveInScalar(A_d, convertRationalVector<double>(b)));
     }
     m_relativeError = computeRelativeError(A, res, b);
     return res;
 }
+
+VectorXmpq LinearSolver::solve(const ModularMatrixFunction& A, const VectorXmpq& b)
+{
+    m_success = true;
+    m_converged = true;
+    const VectorXmpq res = getSolution(solveMultiModular(A, b), b.size(), m_success);
+    m_relativeError = m_success ? 0 : 1;
+    return res;
+}
+
+template<typename Scalar>
+VectorXmpq LinearSolver::solve(const Eigen::MatrixX<Scalar>& A, const VectorXmpq& b)
+{
+    m_success = true;
+    m_converged = true;
+    const Eigen::VectorX<Scalar> b_s = convertRationalVector<Scalar>(b);
+    const Eigen::VectorX<Scalar> x_s = solveInScalar(A, b_s);
+    m_relativeError = computeRelativeError(A, x_s, b_s);
+    return convertVectorToRational(x_s);
+}
+
+template<typename Scalar>
+VectorXmpq LinearSolver::solve(const Eigen::SparseMatrix<Scalar>& A, const VectorXmpq& b)
+{
+    m_success = true;
+    m_converged = true;
+    const Eigen::VectorX<Scalar> b_s = convertRationalVector<Scalar>(b);
+    const Eigen::VectorX<Scalar> x_s = solveInScalar(A, b_s);
+    m_relativeError = computeRelativeError(A, x_s, b_s);
+    return convertVectorToRational(x_s);
+}
+
+template<typename Scalar>
+VectorXmpq LinearSolver::solve(const StiffnessOperator<Scalar>& A, const VectorXmpq& b)
+{
+    m_success = true;
+    m_converged = true;
+    const Eigen::VectorX<Scalar> b_s = convertRationalVector<Scalar>(b);
+    const Eigen::VectorX<Scalar> x_s = solveIteratively(A, b_s);
+    m_relativeError = computeRelativeError(A, x_s, b_s);
+    return convertVectorToRational(x_s);
+}
+
+template VectorXmpq LinearSolver::solve<mpf_class>(const MatrixXmpf&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<mpf_class>(const Eigen::SparseMatrix<mpf_class>&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<double>(const Eigen::MatrixXd&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<double>(const Eigen::SparseMatrix<double>&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<long double>(const Eigen::MatrixX<long double>&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<long double>(const Eigen::SparseMatrix<long double>&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<mpf_class>(const StiffnessOperator<mpf_class>&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<double>(const StiffnessOperator<double>&, const VectorXmpq&);
+template VectorXmpq LinearSolver::solve<long double>(const StiffnessOperator<long double>&, const VectorXmpq&);
 } // namespace fem
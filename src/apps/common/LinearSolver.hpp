@@ -1,12 +1,19 @@
 #pragma once
 
+#include <any>
+#include <cstdint>
 #include <map>
 #include <string>
+#include <vector>
 
+#include "fem/multiprecision/MultiModularSolver.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
+template<typename Scalar_>
+class StiffnessOperator;
+
 class LinearSolver
 {
 public:
@@ -17,18 +24,80 @@ public:
         ColPivHouseholderQR,
         LLT,
         LDLT,
-        BDCSVD
+        BDCSVD,
+        /* LDL^T factorization which is kept between calls and extended when the next system contains the previous
+         * one as its leading principal block (see --hierarchical-ordering). Sparse systems are solved as dense. */
+        IncrementalLDLT,
+        /* Block-Jacobi preconditioned conjugate gradient, see setPreconditionerBlocks */
+        ConjugateGradient,
+        /* Mixed-precision iterative refinement: LDL^T factorization in double, residuals in the scalar type of the
+         * system, i.e. exactly for mpq_class systems and at the mpf_class precision for mpf_class systems */
+        IterativeRefinement,
+        /* Exact fraction-free elimination over the integers, see solveFractionFree. Floating-point systems are
+         * converted to rationals, solved exactly and rounded back. */
+        FractionFree,
+        /* Exact solution modulo 62-bit primes with CRT and rational reconstruction, see solveMultiModular.
+         * Floating-point systems are handled as with FractionFree. */
+        MultiModular
     };
 
 public:
     explicit LinearSolver(Method method);
 
     VectorXmpq solve(const MatrixXmpq& A, const VectorXmpq& b);
+    /* Methods without a sparse counterpart (FullPivLU, BDCSVD) fall back to the dense solver, as does PartialPivLU to
+     * stay exact */
+    VectorXmpq solve(const SparseMatrixXmpq& A, const VectorXmpq& b);
+    /* Floating-point systems (mpf_class, double, long double) are solved in their own scalar type and the
+     * relative error is measured against the floating-point system */
+    template<typename Scalar>
+    VectorXmpq solve(const Eigen::MatrixX<Scalar>& A, const VectorXmpq& b);
+    template<typename Scalar>
+    VectorXmpq solve(const Eigen::SparseMatrix<Scalar>& A, const VectorXmpq& b);
+    /* Matrix-free systems are solved with ConjugateGradient regardless of the method */
+    template<typename Scalar>
+    VectorXmpq solve(const StiffnessOperator<Scalar>& A, const VectorXmpq& b);
+    /* Systems given by their residues modulo primes are solved with MultiModular regardless of the method. The
+     * solution is exact, so the relative error is zero unless the solve failed. */
+    VectorXmpq solve(const ModularMatrixFunction& A, const VectorXmpq& b);
+    Method getMethod() const { return m_method; }
     mpf_class getRelativeError() const { return m_relativeError; }
+    /* False if the factorization of the latest solve failed, in which case the solution is meaningless */
+    bool isSuccessful() const { return m_success; }
+    /* False if the latest ConjugateGradient or IterativeRefinement solve stopped before the relative residual reached
+     * the tolerance, e.g. because the refinement stalled at the precision of the scalar type */
+    bool hasConverged() const { return m_converged; }
+
+    /* Relative residual at which ConjugateGradient and IterativeRefinement stop */
+    void setTolerance(double tolerance) { m_tolerance = tolerance; }
+    /* Groups of unknowns of the following systems whose diagonal blocks form the ConjugateGradient preconditioner.
+     * Unknowns not in any group are preconditioned by their diagonal entry. */
+    void setPreconditionerBlocks(const std::vector<std::vector<uint32_t>>& blocks) { m_preconditionerBlocks = blocks; }
+    /* Iterations of the latest ConjugateGradient or IterativeRefinement solve */
+    uint32_t getNumOfIterations() const { return m_numOfIterations; }
+
+private:
+    template<typename Scalar>
+    Eigen::VectorX<Scalar> solveInScalar(const Eigen::MatrixX<Scalar>& A, const Eigen::VectorX<Scalar>& b);
+    template<typename Scalar>
+    Eigen::VectorX<Scalar> solveInScalar(const Eigen::SparseMatrix<Scalar>& A, const Eigen::VectorX<Scalar>& b);
+    template<typename MatrixType, typename Scalar>
+    Eigen::VectorX<Scalar> solveIteratively(const MatrixType& A, const Eigen::VectorX<Scalar>& b);
+    template<typename Scalar>
+    Eigen::VectorX<Scalar> refineIteratively(const Eigen::MatrixX<Scalar>& A, const Eigen::VectorX<Scalar>& b);
+    template<typename Scalar>
+    Eigen::VectorX<Scalar> refineIteratively(const Eigen::SparseMatrix<Scalar>& A, const Eigen::VectorX<Scalar>& b);
 
 private:
     Method m_method;
     mpf_class m_relativeError;
+    /* IncrementalLDLT<Scalar> of the previous system */
+    std::any m_incrementalLDLT;
+    double m_tolerance;
+    std::vector<std::vector<uint32_t>> m_preconditionerBlocks;
+    uint32_t m_numOfIterations;
+    bool m_success;
+    bool m_converged;
 };
 
 inline const std::map<LinearSolver::Method, std::string> linearSolverMethodCliNames{
@@ -37,7 +106,12 @@ inline const std::map<LinearSolver::Method, std::string> linearSolverMethodCliNa
     {LinearSolver::LLT, "llt"},
     {LinearSolver::LDLT, "ldlt"},
     {LinearSolver::BDCSVD, "bdcsvd"},
-    {LinearSolver::FullPivLU, "full-piv-lu"}
+    {LinearSolver::FullPivLU, "full-piv-lu"},
+    {LinearSolver::IncrementalLDLT, "incremental-ldlt"},
+    {LinearSolver::ConjugateGradient, "conjugate-gradient"},
+    {LinearSolver::IterativeRefinement, "iterative-refinement"},
+    {LinearSolver::FractionFree, "fraction-free"},
+    {LinearSolver::MultiModular, "multi-modular"}
 
 };
 } // namespace fem
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace fem
+{
+/* Scalar type used for assembling and solving the system of equations and for computing the L2 error. The precision
+ * of mpf is set by --precision. */
+enum ScalarType
+{
+    ScalarType_Mpq,
+    ScalarType_Mpf,
+    ScalarType_Double,
+    ScalarType_LongDouble
+};
+
+inline const std::map<ScalarType, std::string> scalarTypeCliNames{
+    {ScalarType_Mpq, "mpq"},
+    {ScalarType_Mpf, "mpf"},
+    {ScalarType_Double, "double"},
+    {ScalarType_LongDouble, "long-double"}
+};
+} // namespace fem
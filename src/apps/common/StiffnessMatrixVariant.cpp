@@ -0,0 +1,180 @@
+#include "apps/common/StiffnessMatrixVariant.hpp"
+
+#include <optional>
+#include <type_traits>
+
+#include "fem/assembly/StaticCondensation.hpp"
+#include "fem/assembly/StiffnessMatrix.hpp"
+#include "fem/basis/BasisFunctionIndexer.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
+
+namespace fem
+{
+namespace
+{
+template<typename Scalar>
+StiffnessMatrixVariant assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, bool sparse)
+{
+    if (sparse)
+    {
+        return assembleSparseStiffnessMatrix<Scalar>(ctx, shapeFunctionFactory);
+    }
+    else
+    {
+        return assembleStiffnessMatrix<Scalar>(ctx, shapeFunctionFactory);
+    }
+}
+
+template<typename Scalar>
+VectorXmpq solveMatrixFree(LinearSolver& linearSolver, const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, const VectorXmpq& b)
+{
+    const StiffnessOperator<Scalar> A(ctx, shapeFunctionFactory, true);
+    return linearSolver.solve(A, b);
+}
+
+/* Maps the indices of the blocks to those of the system, dropping the ones mapped to a negative index */
+template<typename IndexMap>
+std::vector<std::vector<uint32_t>> mapPreconditionerBlocks(const std::vector<std::vector<uint32_t>>& blocks, const IndexMap& indexMap)
+{
+    std::vector<std::vector<uint32_t>> res;
+    for (const auto& block : blocks)
+    {
+        std::vector<uint32_t> mappedBlock;
+        for (uint32_t i : block)
+        {
+            const int j = indexMap(i);
+            if (j >= 0)
+            {
+                mappedBlock.push_back(j);
+            }
+        }
+        if (!mappedBlock.empty())
+        {
+            res.push_back(mappedBlock);
+        }
+    }
+    return res;
+}
+} // namespace
+
+StiffnessMatrixVariant assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, ScalarType scalarType, bool sparse)
+{
+    if (scalarType == ScalarType_Mpq)
+    {
+        return assembleStiffnessMatrix<mpq_class>(ctx, shapeFunctionFactory, sparse);
+    }
+    else if (scalarType == ScalarType_Mpf)
+    {
+        return assembleStiffnessMatrix<mpf_class>(ctx, shapeFunctionFactory, sparse);
+    }
+    else if (scalarType == ScalarType_Double)
+    {
+        return assembleStiffnessMatrix<double>(ctx, shapeFunctionFactory, sparse);
+    }
+    else
+    {
+        return assembleStiffnessMatrix<long double>(ctx, shapeFunctionFactory, sparse);
+    }
+}
+
+StiffnessMatrixVariant enrichStiffnessMatrix(const FemContext& ctx, const StiffnessMatrixVariant& stiffnessMatrix, const ShapeFunctionFactory& shapeFunctionFactory)
+{
+    return std::visit([&ctx, &shapeFunctionFactory](const auto& matrix) -> StiffnessMatrixVariant
+    {
+        return enrichStiffnessMatrix(ctx, matrix, shapeFunctionFactory);
+    }, stiffnessMatrix);
+}
+
+StiffnessMatrixVariant extractSubStiffnessMatrix(const FemContext& ctx, const StiffnessMatrixVariant& stiffnessMatrix, uint32_t p)
+{
+    return std::visit([&ctx, p](const auto& matrix) -> StiffnessMatrixVariant
+    {
+        return extractSubStiffnessMatrix(ctx, matrix, p);
+    }, stiffnessMatrix);
+}
+
+StiffnessMatrixVariant extractReducedStiffnessMatrix(const FemContext& ctx, const StiffnessMatrixVariant& stiffnessMatrix, uint32_t p)
+{
+    return std::visit([&ctx, p](const auto& matrix) -> StiffnessMatrixVariant
+    {
+        return reduceStiffnessMatrix(extractSubStiffnessMatrix(ctx, matrix, p));
+    }, stiffnessMatrix);
+}
+
+StiffnessMatrixVariant reduceStiffnessMatrix(const StiffnessMatrixVariant& stiffnessMatrix)
+{
+    return std::visit([](const auto& matrix) -> StiffnessMatrixVariant
+    {
+        using MatrixType = std::decay_t<decltype(matrix)>;
+        const uint32_t dim = matrix.rows();
+        return MatrixType(matrix.bottomRightCorner(dim-1, dim-1));
+    }, stiffnessMatrix);
+}
+
+std::vector<std::vector<uint32_t>> getReducedPreconditionerBlocks(const FemContext& ctx)
+{
+    return mapPreconditionerBlocks(getSideAndInternalBasisFunctionBlocks(ctx), [](uint32_t i) { return static_cast<int>(i) - 1; });
+}
+
+VectorXmpq solve(LinearSolver& linearSolver, const StiffnessMatrixVariant& A, const VectorXmpq& b)
+{
+    return std::visit([&linearSolver, &b](const auto& matrix) { return linearSolver.solve(matrix, b); }, A);
+}
+
+VectorXmpq solveMatrixFree(LinearSolver& linearSolver, const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, ScalarType scalarType, const VectorXmpq& b)
+{
+    linearSolver.setPreconditionerBlocks(getReducedPreconditionerBlocks(ctx));
+    if (scalarType == ScalarType_Mpf)
+    {
+        return solveMatrixFree<mpf_class>(linearSolver, ctx, shapeFunctionFactory, b);
+    }
+    else if (scalarType == ScalarType_LongDouble)
+    {
+        return solveMatrixFree<long double>(linearSolver, ctx, shapeFunctionFactory, b);
+    }
+    else
+    {
+        return solveMatrixFree<double>(linearSolver, ctx, shapeFunctionFactory, b);
+    }
+}
+
+VectorXmpq solveWithModularAssembly(LinearSolver& linearSolver, const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, const VectorXmpq& b)
+{
+    const ModularStiffnessMatrixAssembler assembler(ctx, shapeFunctionFactory);
+    const uint32_t dim = b.size();
+    return linearSolver.solve([&assembler, dim](uint64_t prime) -> std::optional<ModularSparseMatrix>
+    {
+        const std::optional<ModularSparseMatrix> stiffnessMatrix = assembler.assemble(prime);
+        if (!stiffnessMatrix)
+        {
+            return std::nullopt;
+        }
+        return ModularSparseMatrix(stiffnessMatrix->bottomRightCorner(dim, dim));
+    }, b);
+}
+
+VectorXmpq solveWithStaticCondensation(LinearSolver& linearSolver, const FemContext& ctx, const StiffnessMatrixVariant& A, const VectorXmpq& b)
+{
+    return std::visit([&linearSolver, &ctx, &b](const auto& matrix)
+    {
+        using MatrixType = std::decay_t<decltype(matrix)>;
+        using Scalar = typename MatrixType::Scalar;
+        const StaticCondensation<MatrixType> staticCondensation(ctx, matrix);
+        const Eigen::VectorX<Scalar> b_s = b.unaryExpr([](const mpq_class& elem) { return convertRational<Scalar>(elem); });
+        const VectorXmpq condensedLoadVector = staticCondensation.condenseLoadVector(b_s).unaryExpr([](const Scalar& elem) { return convertToRational(elem); });
+        const uint32_t dim = condensedLoadVector.size();
+        const StiffnessMatrixVariant condensedStiffnessMatrix = reduceStiffnessMatrix(staticCondensation.getCondensedStiffnessMatrix());
+        if (linearSolver.getMethod() == LinearSolver::ConjugateGradient)
+        {
+            const auto& globalToCondensed = staticCondensation.getGlobalToCondensed();
+            linearSolver.setPreconditionerBlocks(mapPreconditionerBlocks(getSideAndInternalBasisFunctionBlocks(ctx),
+                [&globalToCondensed](uint32_t i) { return globalToCondensed[i] - 1; }));
+        }
+        const VectorXmpq x = solve(linearSolver, condensedStiffnessMatrix, condensedLoadVector.segment(1, dim-1));
+        Eigen::VectorX<Scalar> condensedSolution(dim);
+        condensedSolution(0) = 0;
+        condensedSolution.segment(1, dim-1) = x.unaryExpr([](const mpq_class& elem) { return convertRational<Scalar>(elem); });
+        return VectorXmpq(staticCondensation.expandSolution(condensedSolution, b_s).unaryExpr([](const Scalar& elem) { return convertToRational(elem); }));
+    }, A);
+}
+} // namespace fem
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+#include "apps/common/LinearSolver.hpp"
+#include "apps/common/ScalarType.hpp"
+#include "fem/basis/FemContext.hpp"
+#include "fem/basis/ShapeFunctionFactory.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+using StiffnessMatrixVariant = std::variant<
+    MatrixXmpq, SparseMatrixXmpq,
+    MatrixXmpf, Eigen::SparseMatrix<mpf_class>,
+    Eigen::MatrixXd, Eigen::SparseMatrix<double>,
+    Eigen::MatrixX<long double>, Eigen::SparseMatrix<long double>>;
+
+StiffnessMatrixVariant assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, ScalarType scalarType, bool sparse);
+
+/* Stiffness matrix of degree ctx.p from the one of degree ctx.p - 1, keeping the scalar type and storage */
+StiffnessMatrixVariant enrichStiffnessMatrix(const FemContext& ctx, const StiffnessMatrixVariant& stiffnessMatrix, const ShapeFunctionFactory& shapeFunctionFactory);
+
+StiffnessMatrixVariant extractSubStiffnessMatrix(const FemContext& ctx, const StiffnessMatrixVariant& stiffnessMatrix, uint32_t p);
+/* Sub stiffness matrix of degree p without the first row and column, i.e. with the first nodal value pinned to zero */
+StiffnessMatrixVariant extractReducedStiffnessMatrix(const FemContext& ctx, const StiffnessMatrixVariant& stiffnessMatrix, uint32_t p);
+/* The stiffness matrix without the first row and column */
+StiffnessMatrixVariant reduceStiffnessMatrix(const StiffnessMatrixVariant& stiffnessMatrix);
+
+/* Side and internal blocks of the basis of degree ctx.p without the first nodal basis function, for the preconditioner
+ * of LinearSolver::ConjugateGradient */
+std::vector<std::vector<uint32_t>> getReducedPreconditionerBlocks(const FemContext& ctx);
+
+VectorXmpq solve(LinearSolver& linearSolver, const StiffnessMatrixVariant& A, const VectorXmpq& b);
+/* Solves the system of degree ctx.p with the first nodal value pinned to zero without assembling the stiffness matrix.
+ * b is the load vector without its first entry. mpq_class is treated as double. */
+VectorXmpq solveMatrixFree(LinearSolver& linearSolver, const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, ScalarType scalarType, const VectorXmpq& b);
+/* Solves the mpq_class system of degree ctx.p with the first nodal value pinned to zero with LinearSolver::MultiModular,
+ * assembling the stiffness matrix modulo each prime instead of in rationals. b is the load vector without its first
+ * entry. */
+VectorXmpq solveWithModularAssembly(LinearSolver& linearSolver, const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, const VectorXmpq& b);
+
+/* A is the stiffness matrix of degree ctx.p and b the load vector. The internal coefficients are eliminated before the
+ * solve and the first nodal value is pinned to zero. Returns the coefficients of all the basis functions. */
+VectorXmpq solveWithStaticCondensation(LinearSolver& linearSolver, const FemContext& ctx, const StiffnessMatrixVariant& A, const VectorXmpq& b);
+} // namespace fem
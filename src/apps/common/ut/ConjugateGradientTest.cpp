@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include "apps/common/ConjugateGradient.hpp"
+
+namespace fem::ut
+{
+namespace
+{
+/* Symmetric positive definite 1D Laplacian with a varying diagonal */
+Eigen::SparseMatrix<double> createSpdMatrix(int n)
+{
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int i = 0; i < n; i++)
+    {
+        triplets.emplace_back(i, i, 2.0 + 1.0 / (i + 1));
+        if (i + 1 < n)
+        {
+            triplets.emplace_back(i, i + 1, -1.0);
+            triplets.emplace_back(i + 1, i, -1.0);
+        }
+    }
+    Eigen::SparseMatrix<double> A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+Eigen::VectorXd createRightHandSide(int n)
+{
+    Eigen::VectorXd b(n);
+    for (int i = 0; i < n; i++)
+    {
+        b(i) = (i % 3 - 1) / (i + 2.0);
+    }
+    return b;
+}
+
+std::vector<uint32_t> createRange(uint32_t begin, uint32_t end)
+{
+    std::vector<uint32_t> res(end - begin);
+    std::iota(res.begin(), res.end(), begin);
+    return res;
+}
+} // namespace
+
+TEST(ConjugateGradientTest, BlockJacobiPreconditionedSystem)
+{
+    const int n = 40;
+    const double tolerance = 1e-12;
+    const Eigen::SparseMatrix<double> A = createSpdMatrix(n);
+    const Eigen::VectorXd b = createRightHandSide(n);
+    std::vector<std::vector<uint32_t>> blocks;
+    for (int i = 0; i < n; i += 8)
+    {
+        blocks.push_back(createRange(i, i + 8));
+    }
+    const BlockJacobiPreconditioner<double> preconditioner(A, blocks);
+    ConjugateGradient<double> conjugateGradient(tolerance, n);
+    const Eigen::VectorXd x = conjugateGradient.solve(A, b, preconditioner);
+    EXPECT_TRUE(conjugateGradient.hasConverged());
+    EXPECT_LE((b - A * x).norm(), tolerance * b.norm());
+    /* The coupling between the 5 blocks has rank 8, so the preconditioned matrix has at most 9 distinct eigenvalues
+     * and the iteration ends after 9 steps up to rounding */
+    EXPECT_GT(conjugateGradient.getNumOfIterations(), 0);
+    EXPECT_LE(conjugateGradient.getNumOfIterations(), 10);
+
+    /* The dense matrix gives the same iterates */
+    const Eigen::MatrixXd A_dense(A);
+    const BlockJacobiPreconditioner<double> densePreconditioner(A_dense, blocks);
+    ConjugateGradient<double> denseConjugateGradient(tolerance, n);
+    const Eigen::VectorXd x_dense = denseConjugateGradient.solve(A_dense, b, densePreconditioner);
+    EXPECT_EQ(denseConjugateGradient.getNumOfIterations(), conjugateGradient.getNumOfIterations());
+    EXPECT_LE((x_dense - x).norm(), 1e-12 * x.norm());
+}
+
+TEST(ConjugateGradientTest, SingleBlockIsExactPreconditioner)
+{
+    const int n = 10;
+    const Eigen::SparseMatrix<double> A = createSpdMatrix(n);
+    const Eigen::VectorXd b = createRightHandSide(n);
+    const BlockJacobiPreconditioner<double> preconditioner(A, {createRange(0, n)});
+    ConjugateGradient<double> conjugateGradient(1e-12, n);
+    const Eigen::VectorXd x = conjugateGradient.solve(A, b, preconditioner);
+    EXPECT_TRUE(conjugateGradient.hasConverged());
+    EXPECT_EQ(conjugateGradient.getNumOfIterations(), 1);
+    EXPECT_LE((b - A * x).norm(), 1e-12 * b.norm());
+}
+
+TEST(ConjugateGradientTest, ReportsMissedTolerance)
+{
+    const int n = 40;
+    const Eigen::SparseMatrix<double> A = createSpdMatrix(n);
+    const Eigen::VectorXd b = createRightHandSide(n);
+    const BlockJacobiPreconditioner<double> preconditioner(A, {});
+    ConjugateGradient<double> conjugateGradient(1e-12, 3);
+    const Eigen::VectorXd x = conjugateGradient.solve(A, b, preconditioner);
+    EXPECT_FALSE(conjugateGradient.hasConverged());
+    EXPECT_EQ(conjugateGradient.getNumOfIterations(), 3);
+    EXPECT_GT((b - A * x).norm(), 1e-12 * b.norm());
+}
+} // namespace fem::ut
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "apps/common/IncrementalLDLT.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem::ut
+{
+namespace
+{
+/* Symmetric positive definite (strictly diagonally dominant) matrix with rational entries */
+MatrixXmpq createSpdMatrix(int n)
+{
+    MatrixXmpq A(n, n);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            A(i,j) = mpq_class(1) / (i + j + 2);
+        }
+        A(i,i) += n;
+    }
+    return A;
+}
+
+VectorXmpq createRightHandSide(int n)
+{
+    VectorXmpq b(n);
+    for (int i = 0; i < n; i++)
+    {
+        b(i) = mpq_class(i % 3 - 1) / (i + 2);
+    }
+    return b;
+}
+} // namespace
+
+TEST(IncrementalLDLTTest, NestedSystems)
+{
+    const int n = 9;
+    const MatrixXmpq A = createSpdMatrix(n);
+    IncrementalLDLT<mpq_class> incrementalLDLT;
+    for (const int m : {2, 5, 9})
+    {
+        const MatrixXmpq A_m = A.topLeftCorner(m, m);
+        const VectorXmpq b = createRightHandSide(m);
+        const VectorXmpq x = incrementalLDLT.compute(A_m).solve(b);
+        EXPECT_EQ(x, IncrementalLDLT<mpq_class>().compute(A_m).solve(b));
+        EXPECT_EQ(A_m * x, b);
+    }
+}
+
+TEST(IncrementalLDLTTest, FallsBackIfNotLeadingBlock)
+{
+    const int n = 7;
+    MatrixXmpq A = createSpdMatrix(n);
+    const VectorXmpq b = createRightHandSide(n);
+    IncrementalLDLT<mpq_class> incrementalLDLT;
+    incrementalLDLT.compute(A.topLeftCorner(4, 4));
+
+    /* The leading block changed */
+    A(1,1) += 1;
+    const VectorXmpq x = incrementalLDLT.compute(A).solve(b);
+    EXPECT_EQ(x, IncrementalLDLT<mpq_class>().compute(A).solve(b));
+    EXPECT_EQ(A * x, b);
+
+    /* The system shrinks */
+    const MatrixXmpq A_3 = A.topLeftCorner(3, 3);
+    const VectorXmpq b_3 = b.head(3);
+    const VectorXmpq x_3 = incrementalLDLT.compute(A_3).solve(b_3);
+    EXPECT_EQ(x_3, IncrementalLDLT<mpq_class>().compute(A_3).solve(b_3));
+    EXPECT_EQ(A_3 * x_3, b_3);
+}
+
+TEST(IncrementalLDLTTest, ReportsSingularBorder)
+{
+    const int n = 5;
+    MatrixXmpq A = createSpdMatrix(n);
+    const VectorXmpq b = createRightHandSide(n);
+    IncrementalLDLT<mpq_class> incrementalLDLT;
+    EXPECT_EQ(incrementalLDLT.compute(A.topLeftCorner(3, 3)).info(), Eigen::Success);
+
+    /* The last row and column equal the first ones, so the bordered update hits a zero pivot */
+    MatrixXmpq A_singular = A;
+    A_singular.row(n-1) = A_singular.row(0);
+    A_singular.col(n-1) = A_singular.col(0);
+    EXPECT_EQ(incrementalLDLT.compute(A_singular).info(), Eigen::NumericalIssue);
+
+    /* The factor was dropped, so the leading block is not reused */
+    const VectorXmpq x = incrementalLDLT.compute(A).solve(b);
+    EXPECT_EQ(incrementalLDLT.info(), Eigen::Success);
+    EXPECT_EQ(A * x, b);
+}
+} // namespace fem::ut
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "apps/common/LinearSolver.hpp"
+
+namespace fem::ut
+{
+namespace
+{
+/* Symmetric positive definite matrix with rational entries which are not representable in double */
+SparseMatrixXmpq createSpdMatrix(int n)
+{
+    std::vector<Eigen::Triplet<mpq_class>> triplets;
+    for (int i = 0; i < n; i++)
+    {
+        triplets.emplace_back(i, i, mpq_class(2) + mpq_class(1) / (3 * i + 7));
+        if (i + 1 < n)
+        {
+            triplets.emplace_back(i, i + 1, mpq_class(-1) / 3);
+            triplets.emplace_back(i + 1, i, mpq_class(-1) / 3);
+        }
+    }
+    SparseMatrixXmpq A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+}
+
+VectorXmpq createRightHandSide(int n)
+{
+    VectorXmpq b(n);
+    for (int i = 0; i < n; i++)
+    {
+        b(i) = mpq_class(i % 3 - 1) / (i + 2);
+    }
+    return b;
+}
+
+bool isResidualBelow(const SparseMatrixXmpq& A, const VectorXmpq& x, const VectorXmpq& b, const mpq_class& tolerance)
+{
+    const VectorXmpq r = b - A * x;
+    return r.squaredNorm() <= tolerance * tolerance * b.squaredNorm();
+}
+} // namespace
+
+TEST(LinearSolverTest, IterativeRefinementReachesExactTolerance)
+{
+    const int n = 30;
+    const SparseMatrixXmpq A = createSpdMatrix(n);
+    const VectorXmpq b = createRightHandSide(n);
+    LinearSolver linearSolver(LinearSolver::IterativeRefinement);
+    linearSolver.setTolerance(1e-40);
+
+    /* Every step gains about the double precision, so three or four steps suffice for a well-conditioned matrix */
+    const VectorXmpq x = linearSolver.solve(A, b);
+    EXPECT_TRUE(linearSolver.isSuccessful());
+    EXPECT_TRUE(linearSolver.hasConverged());
+    EXPECT_GE(linearSolver.getNumOfIterations(), 3);
+    EXPECT_LE(linearSolver.getNumOfIterations(), 4);
+    EXPECT_TRUE(isResidualBelow(A, x, b, mpq_class(1e-40)));
+
+    const VectorXmpq x_dense = linearSolver.solve(MatrixXmpq(A), b);
+    EXPECT_TRUE(linearSolver.isSuccessful());
+    EXPECT_TRUE(linearSolver.hasConverged());
+    EXPECT_LE(linearSolver.getNumOfIterations(), 4);
+    EXPECT_TRUE(isResidualBelow(A, x_dense, b, mpq_class(1e-40)));
+}
+
+TEST(LinearSolverTest, IterativeRefinementReportsStall)
+{
+    /* The residual of a double system cannot get below the double precision */
+    const int n = 30;
+    const SparseMatrixXmpq A = createSpdMatrix(n);
+    const Eigen::SparseMatrix<double> A_d = A.unaryExpr([](const mpq_class& elem) { return elem.get_d(); });
+    LinearSolver linearSolver(LinearSolver::IterativeRefinement);
+    linearSolver.setTolerance(1e-40);
+    linearSolver.solve(A_d, createRightHandSide(n));
+    EXPECT_TRUE(linearSolver.isSuccessful());
+    EXPECT_FALSE(linearSolver.hasConverged());
+
+    linearSolver.setTolerance(1e-12);
+    linearSolver.solve(A_d, createRightHandSide(n));
+    EXPECT_TRUE(linearSolver.hasConverged());
+}
+
+TEST(LinearSolverTest, IterativeRefinementReportsFailedFactorization)
+{
+    /* Zero leading pivot, which the unpivoted sparse LDL^T cannot handle */
+    SparseMatrixXmpq A(2, 2);
+    A.insert(0, 1) = 1;
+    A.insert(1, 0) = 1;
+    VectorXmpq b(2);
+    b << 1, 2;
+    LinearSolver linearSolver(LinearSolver::IterativeRefinement);
+    linearSolver.solve(A, b);
+    EXPECT_FALSE(linearSolver.isSuccessful());
+}
+
+TEST(LinearSolverTest, ExactSolversReportSingularMatrix)
+{
+    SparseMatrixXmpq A(2, 2);
+    A.insert(0, 0) = 1;
+    A.insert(0, 1) = 1;
+    A.insert(1, 0) = 1;
+    A.insert(1, 1) = 1;
+    VectorXmpq b(2);
+    b << 1, 2;
+    for (const LinearSolver::Method method : {LinearSolver::IncrementalLDLT, LinearSolver::FractionFree, LinearSolver::MultiModular})
+    {
+        LinearSolver linearSolver(method);
+        const VectorXmpq x = linearSolver.solve(A, b);
+        EXPECT_FALSE(linearSolver.isSuccessful());
+        EXPECT_EQ(x, VectorXmpq::Zero(2));
+
+        linearSolver.solve(createSpdMatrix(2), b);
+        EXPECT_TRUE(linearSolver.isSuccessful());
+    }
+}
+} // namespace fem::ut
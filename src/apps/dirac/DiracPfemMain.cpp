@@ -3,16 +3,18 @@
 #include <iomanip>
 #include <iostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <omp.h>
 
 #include "apps/common/Arguments.hpp"
 #include "apps/common/LinearSolver.hpp"
+#include "apps/common/ScalarType.hpp"
+#include "apps/common/StiffnessMatrixVariant.hpp"
 #include "apps/common/Timer.hpp"
 #include "apps/dirac/utils/GreensFunction.hpp"
 #include "apps/dirac/utils/L2Error.hpp"
-#include "fem/basis/ShapeFunctionEvaluator.hpp"
 #include "fem/basis/ShapeFunctionFactory.hpp"
 #include "fem/basis/TrialFunction.hpp"
 #include "fem/assembly/LoadVector.hpp"
@@ -26,29 +28,110 @@ int main(int argc, char* argv[])
 {
     Arguments args(argc, argv);
 
-    const std::string meshFilename = args.getValue<std::string>("mesh-file");
+    /* A structured mesh is generated if --structured-mesh is given, otherwise the mesh is read from --mesh-file */
+    const bool useStructuredMesh = args.hasValue("structured-mesh");
+    std::string meshFilename;
+    StructuredMeshType structuredMeshType = StructuredMeshType_Triangle;
+    uint32_t nx = 0, ny = 0;
+    std::pair<Vector2mpq, Vector2mpq> rectangle;
+    if (useStructuredMesh)
+    {
+        structuredMeshType = args.getValue<StructuredMeshType>("structured-mesh");
+        nx = args.getValue<uint32_t>("nx");
+        ny = args.getValue<uint32_t>("ny");
+        rectangle = args.getValue<std::pair<Vector2mpq, Vector2mpq>>("rectangle");
+    }
+    else
+    {
+        meshFilename = args.getValue<std::string>("mesh-file");
+    }
     const uint32_t p_max = args.getValue<int>("p");
     const PolynomialSpaceType polynomialSpaceType = args.getValue<PolynomialSpaceType>("polynomial-space");
     const Vector2mpq x_0 = args.getValue<Vector2mpq>("dirac-point");
     const fs::path outputDirpath = fs::path(args.getValue<std::string>("output-dir"));
-    const LinearSolver::Method linearSolverMethod = args.getValue<LinearSolver::Method>("linear-solver");
+    const bool useSparseMatrices = args.getValue<bool>("sparse");
+    const bool useMatrixFree = args.getValue<bool>("matrix-free");
+    /* Sparse and matrix-free systems are meant for large meshes, for which the conjugate gradient method is the default */
+    const LinearSolver::Method linearSolverMethod = (useSparseMatrices || useMatrixFree) && !args.hasValue("linear-solver") ? LinearSolver::ConjugateGradient
+                                                                                                                            : args.getValue<LinearSolver::Method>("linear-solver");
+    const double solverTolerance = args.getValue<double>("solver-tolerance");
+    const ScalarType scalarType = args.getValue<ScalarType>("scalar-type");
+    const uint32_t precision = args.getValue<uint32_t>("precision");
+    const bool useIncrementalAssembly = args.getValue<bool>("incremental");
+    const double L2errorTolerance = args.getValue<double>("l2-error-tolerance");
+    /* The incremental solver reuses the factorization only if the systems of lower degree are leading blocks */
+    const BasisFunctionOrdering basisFunctionOrdering = linearSolverMethod == LinearSolver::IncrementalLDLT ? BasisFunctionOrdering_Hierarchical
+                                                                                                             : args.getValue<BasisFunctionOrdering>("hierarchical-ordering");
+    const bool useStaticCondensation = args.getValue<bool>("static-condensation");
 
     std::cout << "Arguments:" << std::endl;
-    std::cout << "--mesh-file " << meshFilename << std::endl;
+    if (useStructuredMesh)
+    {
+        std::cout << "--structured-mesh " << structuredMeshType << std::endl;
+        std::cout << "--nx " << nx << std::endl;
+        std::cout << "--ny " << ny << std::endl;
+        std::cout << "--rectangle " << rectangle.first(0) << " " << rectangle.first(1) << " " << rectangle.second(0) << " " << rectangle.second(1) << std::endl;
+    }
+    else
+    {
+        std::cout << "--mesh-file " << meshFilename << std::endl;
+    }
     std::cout << "--p " << p_max << std::endl;
     std::cout << "--polynomial-space " << polynomialSpaceType << std::endl;
     std::cout << "--dirac-point " << x_0(0) << " " << x_0(1) << std::endl;
     std::cout << "--output-dir " << outputDirpath << std::endl;
     std::cout << "--linear-solver " << linearSolverMethodCliNames.at(linearSolverMethod) << std::endl;
+    if (linearSolverMethod == LinearSolver::ConjugateGradient || linearSolverMethod == LinearSolver::IterativeRefinement)
+    {
+        std::cout << "--solver-tolerance " << solverTolerance << std::endl;
+    }
+    if (useSparseMatrices)
+    {
+        std::cout << "--sparse" << std::endl;
+    }
+    std::cout << "--scalar-type " << scalarTypeCliNames.at(scalarType) << std::endl;
+    std::cout << "--precision " << precision << std::endl;
+    if (useIncrementalAssembly)
+    {
+        std::cout << "--incremental" << std::endl;
+    }
+    std::cout << "--l2-error-tolerance " << L2errorTolerance << std::endl;
+    if (basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        std::cout << "--hierarchical-ordering" << std::endl;
+    }
+    if (useStaticCondensation)
+    {
+        std::cout << "--static-condensation" << std::endl;
+    }
+    if (useMatrixFree)
+    {
+        std::cout << "--matrix-free" << std::endl;
+    }
     std::cout << std::endl;
 
+    if (useMatrixFree && (linearSolverMethod != LinearSolver::ConjugateGradient || useIncrementalAssembly || useStaticCondensation))
+    {
+        std::cout << "--matrix-free requires --linear-solver conjugate-gradient and cannot be combined with --incremental or --static-condensation" << std::endl;
+        return 1;
+    }
+
+    /* The exact multi-modular solver assembles the stiffness matrix modulo its primes, so no rational one is needed */
+    const bool useModularAssembly = linearSolverMethod == LinearSolver::MultiModular && scalarType == ScalarType_Mpq && !useStaticCondensation;
+
+    mpf_set_default_prec(precision);
+
     std::cout << "Number of OpenMP threads: " << omp_get_max_threads() << std::endl;
     std::cout << std::endl;
 
     Timer timer;
-    const auto mesh = std::make_shared<Mesh>(createMeshFromFile(meshFilename));
-    const FemContext ctx(mesh, p_max, polynomialSpaceType);
+    timer.start("Creating mesh... ");
+    const auto mesh = std::make_shared<Mesh>(useStructuredMesh ? createStructuredMesh(structuredMeshType, nx, ny, rectangle.first, rectangle.second)
+                                                               : createMeshFromFile(meshFilename));
+    timer.stop();
+    const FemContext ctx(mesh, p_max, polynomialSpaceType, basisFunctionOrdering);
     LinearSolver linearSolver(linearSolverMethod);
+    linearSolver.setTolerance(solverTolerance);
 
     std::ofstream globalErrorOutputFile;
     std::vector<std::ofstream> elementErrorOutputFiles(mesh->getNumOfElements());
@@ -92,28 +175,31 @@ int main(int argc, char* argv[])
         timer.stop();
     }
 
-    ShapeFunctionEvaluator shapeFunctionEvaluator(shapeFunctionFactory);
+    L2ErrorCalculator l2ErrorCalculator(scalarType, shapeFunctionFactory, *mesh, x_0);
     if (mesh->containsQuadrilateral())
     {
         timer.start("Pre-evaluating quadrilateral shape functions... ");
-        const auto preEvaluationPoints = getShapeFunctionEvaluationPointsForL2Error(ElementType_Parallelogram, *mesh, x_0);
-        shapeFunctionEvaluator.preEvaluate(ElementType_Parallelogram, preEvaluationPoints);
+        l2ErrorCalculator.preEvaluateShapeFunctions(ElementType_Parallelogram);
         timer.stop();
     }
     if (mesh->containsTriangle())
     {
         timer.start("Pre-evaluating triangle shape functions... ");
-        const auto preEvaluationPoints = getShapeFunctionEvaluationPointsForL2Error(ElementType_Triangle, *mesh, x_0);
-        shapeFunctionEvaluator.preEvaluate(ElementType_Triangle, preEvaluationPoints);
+        l2ErrorCalculator.preEvaluateShapeFunctions(ElementType_Triangle);
         timer.stop();
     }
 
-    const auto exact = getNormalizedGreensFunction(x_0, *mesh);
     const auto grad_exact = getGreensFunctionGradient(x_0);
 
-    timer.start("Assembling stiffness matrix... ");
-    const MatrixXmpq stiffnessMatrix = assembleStiffnessMatrix(ctx, shapeFunctionFactory);
-    timer.stop();
+    /* With incremental assembly the stiffness matrix is of the current degree p, otherwise of degree p_max. It is not
+     * assembled at all in the matrix-free mode or with modular assembly. */
+    StiffnessMatrixVariant stiffnessMatrix;
+    if (!useIncrementalAssembly && !useMatrixFree && !useModularAssembly)
+    {
+        timer.start("Assembling stiffness matrix... ");
+        stiffnessMatrix = assembleStiffnessMatrix(ctx, shapeFunctionFactory, scalarType, useSparseMatrices);
+        timer.stop();
+    }
 
     timer.start("Assembling Dirac load vector... ");
     const VectorXmpq diracLoadVector = assembleDiracLoadVector(ctx, x_0, shapeFunctionFactory);
@@ -131,25 +217,101 @@ int main(int argc, char* argv[])
     {
         std::cout << "p=" << p << ":" << std::endl;
 
-        const FemContext subCtx(ctx.mesh, p, ctx.polynomialSpaceType);
+        const FemContext subCtx(ctx.mesh, p, ctx.polynomialSpaceType, ctx.basisFunctionOrdering);
 
-        timer.start("Extracting system of equations... ");
-        const MatrixXmpq subStiffnessMatrix = extractSubStiffnessMatrix(ctx, stiffnessMatrix, p);
-        const VectorXmpq subLoadVector = extractSubLoadVector(ctx, loadVector, p);
-        const uint32_t dim = subLoadVector.size();
-        const MatrixXmpq A = subStiffnessMatrix.block(1, 1, dim-1, dim-1);
-        const VectorXmpq b = subLoadVector.segment(1, dim-1);
-        timer.stop();
+        if (useIncrementalAssembly && !useModularAssembly)
+        {
+            if (p == 1)
+            {
+                timer.start("Assembling stiffness matrix... ");
+                stiffnessMatrix = assembleStiffnessMatrix(subCtx, shapeFunctionFactory, scalarType, useSparseMatrices);
+            }
+            else
+            {
+                timer.start("Enriching stiffness matrix... ");
+                stiffnessMatrix = enrichStiffnessMatrix(subCtx, stiffnessMatrix, shapeFunctionFactory);
+            }
+            timer.stop();
+        }
 
-        timer.start("Solving system of equations... ");
-        const VectorXmpq x = linearSolver.solve(A, b);
-        timer.stop();
+        VectorXmpq coeffs;
+        if (useMatrixFree)
+        {
+            const VectorXmpq subLoadVector = extractSubLoadVector(ctx, loadVector, p);
+            const uint32_t dim = subLoadVector.size();
 
-        std::cout << "Relative error of solution due to floating-point: " << linearSolver.getRelativeError() << std::endl;
+            timer.start("Solving system of equations matrix-free... ");
+            const VectorXmpq x = solveMatrixFree(linearSolver, subCtx, shapeFunctionFactory, scalarType, subLoadVector.segment(1, dim-1));
+            timer.stop();
+
+            coeffs.resize(dim);
+            coeffs(0) = 0;
+            coeffs.segment(1, dim-1) = x;
+        }
+        else if (useModularAssembly)
+        {
+            const VectorXmpq subLoadVector = extractSubLoadVector(ctx, loadVector, p);
+            const uint32_t dim = subLoadVector.size();
+
+            timer.start("Solving system of equations with modular assembly... ");
+            const VectorXmpq x = solveWithModularAssembly(linearSolver, subCtx, shapeFunctionFactory, subLoadVector.segment(1, dim-1));
+            timer.stop();
+
+            coeffs.resize(dim);
+            coeffs(0) = 0;
+            coeffs.segment(1, dim-1) = x;
+        }
+        else if (useStaticCondensation)
+        {
+            timer.start("Extracting system of equations... ");
+            const VectorXmpq b = extractSubLoadVector(ctx, loadVector, p);
+            const StiffnessMatrixVariant A = useIncrementalAssembly ? stiffnessMatrix : extractSubStiffnessMatrix(ctx, stiffnessMatrix, p);
+            timer.stop();
+
+            timer.start("Solving condensed system of equations... ");
+            coeffs = solveWithStaticCondensation(linearSolver, subCtx, A, b);
+            timer.stop();
+        }
+        else
+        {
+            timer.start("Extracting system of equations... ");
+            const VectorXmpq subLoadVector = extractSubLoadVector(ctx, loadVector, p);
+            const uint32_t dim = subLoadVector.size();
+            const VectorXmpq b = subLoadVector.segment(1, dim-1);
+            const StiffnessMatrixVariant A = useIncrementalAssembly ? reduceStiffnessMatrix(stiffnessMatrix)
+                                                                    : extractReducedStiffnessMatrix(ctx, stiffnessMatrix, p);
+            if (linearSolverMethod == LinearSolver::ConjugateGradient)
+            {
+                linearSolver.setPreconditionerBlocks(getReducedPreconditionerBlocks(subCtx));
+            }
+            timer.stop();
+
+            timer.start("Solving system of equations... ");
+            const VectorXmpq x = solve(linearSolver, A, b);
+            timer.stop();
 
-        VectorXmpq coeffs(dim);
-        coeffs(0) = 0;
-        coeffs.segment(1, dim-1) = x;
+            coeffs.resize(dim);
+            coeffs(0) = 0;
+            coeffs.segment(1, dim-1) = x;
+        }
+
+        if (linearSolverMethod == LinearSolver::ConjugateGradient)
+        {
+            std::cout << "Conjugate gradient iterations: " << linearSolver.getNumOfIterations() << std::endl;
+        }
+        else if (linearSolverMethod == LinearSolver::IterativeRefinement)
+        {
+            std::cout << "Iterative refinement iterations: " << linearSolver.getNumOfIterations() << std::endl;
+        }
+        std::cout << "Relative error of solution due to floating-point: " << linearSolver.getRelativeError() << std::endl;
+        if (!linearSolver.isSuccessful())
+        {
+            std::cout << "Warning: the linear solver failed, the solution is not reliable" << std::endl;
+        }
+        if (!linearSolver.hasConverged())
+        {
+            std::cout << "Warning: the iterative solver did not reach the solver tolerance" << std::endl;
+        }
 
         timer.start("Normalizing solution... ");
         normalizeTrialFunction(subCtx, coeffs, shapeFunctionFactory);
@@ -159,7 +321,7 @@ int main(int argc, char* argv[])
         for (int elementIdx = 0; elementIdx < mesh->getNumOfElements(); elementIdx++)
         {
             timer.start("Computing L2 error over element " + std::to_string(elementIdx) + "... ");
-            const mpq_class err = computeSquaredL2ErrorOverElement(subCtx, coeffs, exact, elementIdx, x_0, shapeFunctionEvaluator);
+            const mpq_class err = l2ErrorCalculator.computeSquaredL2ErrorOverElement(subCtx, coeffs, elementIdx);
             timer.stop();
             elementErrorOutputFiles.at(elementIdx) << p << " " << sqrt(mpf_class(err)) << std::endl;
             squaredL2error += err;
@@ -168,6 +330,11 @@ int main(int argc, char* argv[])
         globalErrorOutputFile << p << " " << L2error << std::endl;
         std::cout << "L2 error: " << L2error << std::endl;
         std::cout << "--------------------------------------------------------------" << std::endl;
+        if (L2error <= L2errorTolerance)
+        {
+            std::cout << "L2 error is within the tolerance, stopping at p=" << p << std::endl;
+            break;
+        }
     }
 
     return 0;
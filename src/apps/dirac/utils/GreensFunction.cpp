@@ -1,36 +1,61 @@
 #include "apps/dirac/utils/GreensFunction.hpp"
 
+#include <cmath>
 #include <numbers>
 
 #include "fem/math/Quadrature.hpp"
 #include "fem/multiprecision/Arithmetic.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
-BivariateFunction getGreensFunction(const Vector2mpq& x_0)
+namespace
 {
-    return [x_0](const Vector2mpq& x) -> mpq_class
+double logOfNorm(const Vector2mpq& d)
+{
+    return log(mpq_class(Vector2mpf(d(0), d(1)).norm()));
+}
+
+double logOfNorm(const Vector2mpf& d)
+{
+    return log(mpq_class(d.norm()));
+}
+
+template<typename Float>
+Float logOfNorm(const Eigen::Vector2<Float>& d)
+{
+    return std::log(d.norm());
+}
+} // namespace
+
+template<typename Scalar>
+BasicBivariateFunction<Scalar> getGreensFunction(const Vector2mpq& x_0)
+{
+    const Eigen::Vector2<Scalar> x_0s = x_0.unaryExpr([](const mpq_class& x) { return convertRational<Scalar>(x); });
+    return [x_0s](const Eigen::Vector2<Scalar>& x) -> Scalar
     {
-        if (x == x_0)
+        if (x == x_0s)
         {
             return 0;
         }
-        const Vector2mpq d = x - x_0;
-        return (-std::numbers::inv_pi/2) * log(mpq_class(Vector2mpf(d(0), d(1)).norm()));
+        const Eigen::Vector2<Scalar> d = x - x_0s;
+        const auto logOfDistance = logOfNorm(d);
+        return Scalar((-std::numbers::inv_pi_v<decltype(logOfDistance)>/2) * logOfDistance);
     };
 }
 
-BivariateFunction getNormalizedGreensFunction(const Vector2mpq& x_0, const Mesh& mesh)
+template<typename Scalar>
+BasicBivariateFunction<Scalar> getNormalizedGreensFunction(const Vector2mpq& x_0, const Mesh& mesh)
 {
-    const auto G = getGreensFunction(x_0);
-    mpq_class integralOfG = 0;
+    const auto G = getGreensFunction<Scalar>(x_0);
+    Scalar integralOfG = 0;
     for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
     {
         const Element& element = mesh.getElement(elementIdx);
         integralOfG += integrateGaussLegendre(G, element);
     }
-    const mpq_class normalizationConst = integralOfG / calculateMeshArea(mesh);
-    return [G, normalizationConst](const Vector2mpq& x) -> mpq_class
+    const Scalar normalizationConst = integralOfG / convertRational<Scalar>(calculateMeshArea(mesh));
+    return [G, normalizationConst](const Eigen::Vector2<Scalar>& x) -> Scalar
     {
         return G(x) - normalizationConst;
     };
@@ -48,4 +73,13 @@ GradientFunction getGreensFunctionGradient(const Vector2mpq& x_0)
         return (-std::numbers::inv_pi/2) * d / d.squaredNorm();
     };
 }
+
+#define INSTANTIATE_GREENS_FUNCTION(Scalar) \
+    template BasicBivariateFunction<Scalar> getGreensFunction<Scalar>(const Vector2mpq&); \
+    template BasicBivariateFunction<Scalar> getNormalizedGreensFunction<Scalar>(const Vector2mpq&, const Mesh&);
+
+INSTANTIATE_GREENS_FUNCTION(mpq_class)
+INSTANTIATE_GREENS_FUNCTION(mpf_class)
+INSTANTIATE_GREENS_FUNCTION(double)
+INSTANTIATE_GREENS_FUNCTION(long double)
 } // namespace fem
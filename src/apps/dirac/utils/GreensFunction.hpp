@@ -6,7 +6,11 @@
 
 namespace fem
 {
-BivariateFunction getGreensFunction(const Vector2mpq& x_0);
-BivariateFunction getNormalizedGreensFunction(const Vector2mpq& x_0, const Mesh& mesh);
+/* The logarithm is evaluated in double precision for mpq_class and mpf_class, and in the scalar type otherwise */
+template<typename Scalar = mpq_class>
+BasicBivariateFunction<Scalar> getGreensFunction(const Vector2mpq& x_0);
+/* Normalized to zero mean over the mesh, the integral is computed in the scalar type */
+template<typename Scalar = mpq_class>
+BasicBivariateFunction<Scalar> getNormalizedGreensFunction(const Vector2mpq& x_0, const Mesh& mesh);
 GradientFunction getGreensFunctionGradient(const Vector2mpq& x_0);
 } // namespace fem
@@ -1,53 +1,72 @@
 #include "apps/dirac/utils/L2Error.hpp"
 
+#include "apps/dirac/utils/GreensFunction.hpp"
 #include "fem/basis/TrialFunction.hpp"
 #include "fem/math/Quadrature.hpp"
-#include "fem/multiprecision/Arithmetic.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
 namespace
 {
-const std::vector<Vector2mpq>& getAbscissas(ElementType elementType)
+template<typename Scalar>
+const std::vector<Eigen::Vector2<Scalar>>& getAbscissas(ElementType elementType)
 {
     if (elementType == ElementType_Parallelogram)
     {
-        return defaultGLTableQuad.getAbscissas();
+        return getDefaultGLTableQuad<Scalar>().getAbscissas();
     }
     else
     {
-        return defaultGLTableTri.getAbscissas();
+        return getDefaultGLTableTri<Scalar>().getAbscissas();
     }
 }
+
+/* From the reference element of the sub-element to the one of the element. It is the identity if the element is not
+ * subdivided, so the abscissas are mapped to themselves exactly also when rounding. */
+template<typename Scalar>
+BasicAffineMap<Scalar> getSubElementMap(const AffineMap& Finv, const Element& subElement)
+{
+    return convertAffineMap<Scalar>(compose(Finv, subElement.getReferenceElementMap()));
+}
 } // namespace
 
-mpq_class computeSquaredL2ErrorOverElement(const FemContext& ctx,
-                                           const VectorXmpq& coeffs,
-                                           const BivariateFunction& exact,
-                                           Mesh::ElementIndex elementIdx,
-                                           const Vector2mpq& x_0,
-                                           const ShapeFunctionEvaluator& shapeFunctionEvaluator)
+template<typename Scalar>
+Scalar computeSquaredL2ErrorOverElement(const FemContext& ctx,
+                                        const VectorXmpq& coeffs,
+                                        const BasicBivariateFunction<Scalar>& exact,
+                                        Mesh::ElementIndex elementIdx,
+                                        const Vector2mpq& x_0,
+                                        const BasicShapeFunctionEvaluator<Scalar>& shapeFunctionEvaluator)
 {
-    mpq_class res = 0;
-    auto f = [&ctx, &coeffs, &exact, &shapeFunctionEvaluator](const Vector2mpq& x) -> mpq_class
-    {
-        const mpq_class approx = evaluateTrialFunction(ctx, coeffs, x, shapeFunctionEvaluator);
-        return pow(exact(x) - approx, 2);
-    };
+    Scalar res = 0;
     const Mesh& mesh = *ctx.mesh;
+    const BasicElementTrialFunction<Scalar> elementTrialFunction(ctx, coeffs, elementIdx);
+    const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
     const Element& element = mesh.getElement(elementIdx);
     const auto subElements = element.subdivide(x_0);
+    /* Integrated over the reference elements of the sub-elements instead of mapping the physical quadrature points back
+     * with Finv, which would not hit the pre-evaluated points when rounding */
     for (const auto& elementPtr : subElements)
     {
-        res += integrateGaussLegendre(f, *elementPtr);
+        const AffineMap G = elementPtr->getReferenceElementMap();
+        const BasicAffineMap<Scalar> G_s = convertAffineMap<Scalar>(G);
+        const BasicAffineMap<Scalar> H_s = getSubElementMap<Scalar>(Finv, *elementPtr);
+        auto f = [&elementTrialFunction, &G_s, &H_s, &exact, &shapeFunctionEvaluator](const Eigen::Vector2<Scalar>& x) -> Scalar
+        {
+            const Scalar approx = elementTrialFunction.evaluate(H_s(x), shapeFunctionEvaluator);
+            const Scalar diff = exact(G_s(x)) - approx;
+            return diff * diff;
+        };
+        res += integrateGaussLegendreOverReferenceElement<Scalar>(f, elementPtr->getElementType()) * convertRational<Scalar>(G.A.determinant());
     }
     return res;
 }
 
-std::vector<Vector2mpq> getShapeFunctionEvaluationPointsForL2Error(ElementType elementType, const Mesh& mesh, const Vector2mpq& x_0)
+template<typename Scalar>
+std::vector<Eigen::Vector2<Scalar>> getShapeFunctionEvaluationPointsForL2Error(ElementType elementType, const Mesh& mesh, const Vector2mpq& x_0)
 {
-    const std::vector<Vector2mpq>& abscissas = getAbscissas(elementType);
-    std::vector<Vector2mpq> points = abscissas;
+    std::vector<Eigen::Vector2<Scalar>> points = getAbscissas<Scalar>(elementType);
     for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
     {
         const Element& element = mesh.getElement(elementIdx);
@@ -60,16 +79,69 @@ std::vector<Vector2mpq> getShapeFunctionEvaluationPointsForL2Error(ElementType e
         {
             continue;
         }
-        const AffineMap Finv = element.getReferenceElementMap().inverse();
+        const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
         for (const auto& subElement : subdivision)
         {
-            const AffineMap G = subElement->getReferenceElementMap();
-            for (const auto& x : abscissas)
+            const BasicAffineMap<Scalar> H_s = getSubElementMap<Scalar>(Finv, *subElement);
+            for (const auto& x : getAbscissas<Scalar>(subElement->getElementType()))
             {
-                points.push_back(Finv(G(x)));
+                points.push_back(H_s(x));
             }
         }
     }
     return points;
 }
-} // namespace fem
\ No newline at end of file
+
+#define INSTANTIATE_L2_ERROR_FUNCTIONS(Scalar) \
+    template Scalar computeSquaredL2ErrorOverElement<Scalar>(const FemContext&, const VectorXmpq&, const BasicBivariateFunction<Scalar>&, Mesh::ElementIndex, const Vector2mpq&, const BasicShapeFunctionEvaluator<Scalar>&); \
+    template std::vector<Eigen::Vector2<Scalar>> getShapeFunctionEvaluationPointsForL2Error<Scalar>(ElementType, const Mesh&, const Vector2mpq&);
+
+INSTANTIATE_L2_ERROR_FUNCTIONS(mpq_class)
+INSTANTIATE_L2_ERROR_FUNCTIONS(mpf_class)
+INSTANTIATE_L2_ERROR_FUNCTIONS(double)
+INSTANTIATE_L2_ERROR_FUNCTIONS(long double)
+
+L2ErrorCalculator::L2ErrorCalculator(ScalarType scalarType, const ShapeFunctionFactory& shapeFunctionFactory, const Mesh& mesh, const Vector2mpq& x_0)
+    : m_mesh(mesh)
+    , m_x_0(x_0)
+    , m_state(createState(scalarType, shapeFunctionFactory, mesh, x_0))
+{
+}
+
+void L2ErrorCalculator::preEvaluateShapeFunctions(ElementType elementType)
+{
+    std::visit([this, elementType]<typename Scalar>(State<Scalar>& state)
+    {
+        const auto points = getShapeFunctionEvaluationPointsForL2Error<Scalar>(elementType, m_mesh, m_x_0);
+        state.shapeFunctionEvaluator.preEvaluate(elementType, points);
+    }, m_state);
+}
+
+mpq_class L2ErrorCalculator::computeSquaredL2ErrorOverElement(const FemContext& ctx, const VectorXmpq& coeffs, Mesh::ElementIndex elementIdx) const
+{
+    return std::visit([this, &ctx, &coeffs, elementIdx]<typename Scalar>(const State<Scalar>& state)
+    {
+        return convertToRational(fem::computeSquaredL2ErrorOverElement(ctx, coeffs, state.exact, elementIdx, m_x_0, state.shapeFunctionEvaluator));
+    }, m_state);
+}
+
+L2ErrorCalculator::StateVariant L2ErrorCalculator::createState(ScalarType scalarType, const ShapeFunctionFactory& shapeFunctionFactory, const Mesh& mesh, const Vector2mpq& x_0)
+{
+    if (scalarType == ScalarType_Mpq)
+    {
+        return State<mpq_class>{getNormalizedGreensFunction<mpq_class>(x_0, mesh), ShapeFunctionEvaluator(shapeFunctionFactory)};
+    }
+    else if (scalarType == ScalarType_Mpf)
+    {
+        return State<mpf_class>{getNormalizedGreensFunction<mpf_class>(x_0, mesh), BasicShapeFunctionEvaluator<mpf_class>(shapeFunctionFactory)};
+    }
+    else if (scalarType == ScalarType_Double)
+    {
+        return State<double>{getNormalizedGreensFunction<double>(x_0, mesh), BasicShapeFunctionEvaluator<double>(shapeFunctionFactory)};
+    }
+    else
+    {
+        return State<long double>{getNormalizedGreensFunction<long double>(x_0, mesh), BasicShapeFunctionEvaluator<long double>(shapeFunctionFactory)};
+    }
+}
+} // namespace fem
@@ -1,21 +1,59 @@
 #pragma once
 
+#include <variant>
 #include <vector>
 
+#include "apps/common/ScalarType.hpp"
 #include "fem/basis/FemContext.hpp"
 #include "fem/basis/ShapeFunctionEvaluator.hpp"
+#include "fem/basis/ShapeFunctionFactory.hpp"
 #include "fem/domain/Mesh.hpp"
 #include "fem/math/Function.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
-mpq_class computeSquaredL2ErrorOverElement(const FemContext& ctx,
-                                           const VectorXmpq& coeffs,
-                                           const BivariateFunction& exact,
-                                           Mesh::ElementIndex elementIdx,
-                                           const Vector2mpq& x_0,
-                                           const ShapeFunctionEvaluator& shapeFunctionEvaluator);
-
-std::vector<Vector2mpq> getShapeFunctionEvaluationPointsForL2Error(ElementType elementType, const Mesh& mesh, const Vector2mpq& x_0);
+/* The trial function, the quadrature and the element maps are rounded to Scalar, only mpq_class is exact */
+template<typename Scalar>
+Scalar computeSquaredL2ErrorOverElement(const FemContext& ctx,
+                                        const VectorXmpq& coeffs,
+                                        const BasicBivariateFunction<Scalar>& exact,
+                                        Mesh::ElementIndex elementIdx,
+                                        const Vector2mpq& x_0,
+                                        const BasicShapeFunctionEvaluator<Scalar>& shapeFunctionEvaluator);
+
+/* Exactly the points in the coordinates of the reference element at which computeSquaredL2ErrorOverElement evaluates */
+template<typename Scalar>
+std::vector<Eigen::Vector2<Scalar>> getShapeFunctionEvaluationPointsForL2Error(ElementType elementType, const Mesh& mesh, const Vector2mpq& x_0);
+
+/*
+ * L2 error against the normalized Green's function in the scalar type chosen with --scalar-type. Holds the exact
+ * solution and the shape function evaluator of that type.
+ */
+class L2ErrorCalculator
+{
+public:
+    L2ErrorCalculator(ScalarType scalarType, const ShapeFunctionFactory& shapeFunctionFactory, const Mesh& mesh, const Vector2mpq& x_0);
+
+    void preEvaluateShapeFunctions(ElementType elementType);
+    /* The squared error in the scalar type converted exactly to a rational */
+    mpq_class computeSquaredL2ErrorOverElement(const FemContext& ctx, const VectorXmpq& coeffs, Mesh::ElementIndex elementIdx) const;
+
+private:
+    template<typename Scalar>
+    struct State
+    {
+        BasicBivariateFunction<Scalar> exact;
+        BasicShapeFunctionEvaluator<Scalar> shapeFunctionEvaluator;
+    };
+
+    using StateVariant = std::variant<State<mpq_class>, State<mpf_class>, State<double>, State<long double>>;
+
+    static StateVariant createState(ScalarType scalarType, const ShapeFunctionFactory& shapeFunctionFactory, const Mesh& mesh, const Vector2mpq& x_0);
+
+private:
+    const Mesh& m_mesh;
+    Vector2mpq m_x_0;
+    StateVariant m_state;
+};
 } // namespace fem
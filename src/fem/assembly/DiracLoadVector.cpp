@@ -16,7 +16,7 @@ VectorXmpq assembleDiracLoadVector(const FemContext& ctx, const Vector2mpq& x_0,
     const Mesh::ElementIndex elementIdx = getIndexOfElementContainingPoint(mesh, x_0);
     const Element& element = mesh.getElement(elementIdx);
     const ElementType elementType = element.getElementType();
-    const AffineMap Finv = element.getReferenceElementMap().inverse();
+    const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
     for (int shapeFnIdx = 0; shapeFnIdx < shapeFunctionIndexer.getNumOfShapeFunctions(elementType); shapeFnIdx++)
     {
         const auto desc = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx);
@@ -43,8 +43,7 @@ VectorXmpq assembleDiracLoadVector(const FemContext& ctx, const Vector2mpq& x_0)
     VectorXmpq res(numOfBasisFunctions);
     const Mesh& mesh = *(ctx.mesh);
     const Mesh::ElementIndex elementIdx = getIndexOfElementContainingPoint(mesh, x_0);
-    const Element& element = mesh.getElement(elementIdx);
-    const AffineMap Finv = element.getReferenceElementMap().inverse();
+    const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
     for (int shapeFunctionIdx = 0; shapeFunctionIdx < basisFunctionIndexer.getNumOfShapeFunctions(elementIdx); shapeFunctionIdx++)
     {
         const Polynomial2D v = basisFunctionFactory.getShapeFunction(elementIdx, shapeFunctionIdx);
@@ -25,7 +25,7 @@ VectorXmpq assembleNeumannLoadVector(const FemContext& ctx,
     const Element& element = mesh.getElement(elementIdx);
     const ElementType elementType = element.getElementType();
     const Side side = element.getSide(localSideIdx);
-    const AffineMap Finv = element.getReferenceElementMap().inverse();
+    const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
     auto r = [&side](const mpq_class& t) -> Vector2mpq
     {
         return (1-t)/2 * side.a + (1+t)/2 * side.b;
@@ -100,7 +100,7 @@ VectorXmpq assembleNeumannLoadVector(const FemContext& ctx,
     const uint32_t numOfBasisFunctions = basisFunctionIndexer.getNumOfBasisFunctions();
     VectorXmpq res(numOfBasisFunctions);
     const Element& element = mesh.getElement(elementIdx);
-    const AffineMap Finv = element.getReferenceElementMap().inverse();
+    const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
     const Side side = element.getSide(localSideIdx);
     auto r = [&side](const mpq_class& t) -> Vector2mpq
     {
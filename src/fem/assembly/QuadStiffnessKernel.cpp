@@ -0,0 +1,107 @@
+#include "fem/assembly/QuadStiffnessKernel.hpp"
+
+#include <cassert>
+
+#include "fem/basis/ShapeFunctionIndexer.hpp"
+#include "fem/math/Polynomial.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
+
+namespace fem
+{
+template<typename Scalar>
+QuadStiffnessKernel<Scalar>::QuadStiffnessKernel(uint32_t p, PolynomialSpaceType polynomialSpaceType, const ShapeFunctionFactory& shapeFunctionFactory)
+{
+    const ShapeFunctionIndexer shapeFunctionIndexer(p, polynomialSpaceType);
+    const uint32_t numOfShapeFunctions = shapeFunctionIndexer.getNumOfShapeFunctions(ElementType_Parallelogram);
+    m_factorizations.reserve(numOfShapeFunctions);
+    for (uint32_t shapeFnIdx = 0; shapeFnIdx < numOfShapeFunctions; shapeFnIdx++)
+    {
+        m_factorizations.push_back(getQuadShapeFunctionFactorization(shapeFunctionIndexer.getShapeFunctionDescriptor(ElementType_Parallelogram, shapeFnIdx)));
+    }
+
+    const std::vector<Polynomial1D>& factors = shapeFunctionFactory.getQuadShapeFunctionFactors();
+    assert(factors.size() >= p + 1);
+    const uint32_t numOfFactors = p + 1;
+    m_mass.resize(numOfFactors, numOfFactors);
+    m_stiffness.resize(numOfFactors, numOfFactors);
+    m_gradient.resize(numOfFactors, numOfFactors);
+    for (uint32_t i = 0; i < numOfFactors; i++)
+    {
+        const Polynomial1D factorDt = diff(factors[i]);
+        for (uint32_t j = 0; j < numOfFactors; j++)
+        {
+            m_mass(i,j) = convertRational<Scalar>(integrateOverReferenceInterval(factors[i] * factors[j]));
+            m_stiffness(i,j) = convertRational<Scalar>(integrateOverReferenceInterval(factorDt * diff(factors[j])));
+            m_gradient(i,j) = convertRational<Scalar>(integrateOverReferenceInterval(factorDt * factors[j]));
+        }
+    }
+}
+
+template<typename Scalar>
+typename QuadStiffnessKernel<Scalar>::GradientProductIntegrals QuadStiffnessKernel<Scalar>::getReferenceIntegrals(uint32_t shapeFnIdx1, uint32_t shapeFnIdx2) const
+{
+    const QuadShapeFunctionFactorization& f1 = m_factorizations[shapeFnIdx1];
+    const QuadShapeFunctionFactorization& f2 = m_factorizations[shapeFnIdx2];
+    const uint32_t a1 = f1.xFactorIdx;
+    const uint32_t b1 = f1.yFactorIdx;
+    const uint32_t a2 = f2.xFactorIdx;
+    const uint32_t b2 = f2.yFactorIdx;
+    GradientProductIntegrals res{m_stiffness(a1,a2) * m_mass(b1,b2),
+                                 m_gradient(a1,a2) * m_gradient(b2,b1),
+                                 m_gradient(a2,a1) * m_gradient(b1,b2),
+                                 m_mass(a1,a2) * m_stiffness(b1,b2)};
+    if (f1.sign != f2.sign)
+    {
+        res.xx = -res.xx;
+        res.xy = -res.xy;
+        res.yx = -res.yx;
+        res.yy = -res.yy;
+    }
+    return res;
+}
+
+template<typename Scalar>
+Eigen::VectorX<Scalar> QuadStiffnessKernel<Scalar>::apply(const Eigen::Matrix2<Scalar>& G, const Eigen::VectorX<Scalar>& x) const
+{
+    assert(x.size() == m_factorizations.size());
+    const uint32_t numOfFactors = m_mass.rows();
+    Eigen::MatrixX<Scalar> X = Eigen::MatrixX<Scalar>::Zero(numOfFactors, numOfFactors);
+    for (int i = 0; i < m_factorizations.size(); i++)
+    {
+        const QuadShapeFunctionFactorization& f = m_factorizations[i];
+        X(f.xFactorIdx, f.yFactorIdx) = (f.sign > 0) ? x(i) : Scalar(-x(i));
+    }
+    /* G is symmetric so the xy and yx terms share the coefficient */
+    Eigen::MatrixX<Scalar> Y = G(0,0) * (m_stiffness * X * m_mass);
+    Y += G(0,1) * (m_gradient * X * m_gradient + m_gradient.transpose() * X * m_gradient.transpose());
+    Y += G(1,1) * (m_mass * X * m_stiffness);
+    Eigen::VectorX<Scalar> res(m_factorizations.size());
+    for (int i = 0; i < m_factorizations.size(); i++)
+    {
+        const QuadShapeFunctionFactorization& f = m_factorizations[i];
+        res(i) = (f.sign > 0) ? Y(f.xFactorIdx, f.yFactorIdx) : Scalar(-Y(f.xFactorIdx, f.yFactorIdx));
+    }
+    return res;
+}
+
+template<typename Scalar>
+Eigen::MatrixX<Scalar> QuadStiffnessKernel<Scalar>::getElementMatrix(const Eigen::Matrix2<Scalar>& G) const
+{
+    const uint32_t numOfShapeFunctions = m_factorizations.size();
+    Eigen::MatrixX<Scalar> res(numOfShapeFunctions, numOfShapeFunctions);
+    for (uint32_t j = 0; j < numOfShapeFunctions; j++)
+    {
+        for (uint32_t i = 0; i < numOfShapeFunctions; i++)
+        {
+            const GradientProductIntegrals integrals = getReferenceIntegrals(i, j);
+            res(i,j) = G(0,0) * integrals.xx + G(0,1) * integrals.xy + G(1,0) * integrals.yx + G(1,1) * integrals.yy;
+        }
+    }
+    return res;
+}
+
+template class QuadStiffnessKernel<mpq_class>;
+template class QuadStiffnessKernel<mpf_class>;
+template class QuadStiffnessKernel<double>;
+template class QuadStiffnessKernel<long double>;
+} // namespace fem
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "fem/basis/PolynomialSpaceType.hpp"
+#include "fem/basis/ShapeFunctionFactory.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/*
+ * Sum-factorized stiffness kernel of the reference quadrilateral. The quad shape functions are products of the 1D
+ * factors f_i (see QuadShapeFunctionFactorization), so the integrals of the gradient products split into the 1D tables
+ *     M(i,j) = (f_i, f_j),  K(i,j) = (f_i', f_j'),  D(i,j) = (f_i', f_j)
+ * over [-1, 1], e.g. (dx phi_1, dx phi_2) = K(a_1,a_2) * M(b_1,b_2) for phi_n = f_a_n(x) * f_b_n(y). With the
+ * coefficients arranged into the (p+1)x(p+1) matrix X(a,b), the element matrix of G = det(A) A^-1 A^-T is applied as
+ *     Y = G(0,0) K*X*M + G(0,1) (D*X*D + D^T*X*D^T) + G(1,1) M*X*K
+ * in O(p^3) operations instead of O(p^4). The tables are computed exactly, so with Scalar = mpq_class the results are
+ * exactly the same as with the 2D integrals.
+ */
+template<typename Scalar>
+class QuadStiffnessKernel
+{
+public:
+    /* Integrals of the products of the partial derivatives of two shape functions over the reference element */
+    struct GradientProductIntegrals
+    {
+        Scalar xx;
+        Scalar xy;
+        Scalar yx;
+        Scalar yy;
+    };
+
+    QuadStiffnessKernel(uint32_t p, PolynomialSpaceType polynomialSpaceType, const ShapeFunctionFactory& shapeFunctionFactory);
+
+    uint32_t getNumOfShapeFunctions() const { return m_factorizations.size(); }
+    GradientProductIntegrals getReferenceIntegrals(uint32_t shapeFnIdx1, uint32_t shapeFnIdx2) const;
+    /* Element matrix times x, without side orientation signs */
+    Eigen::VectorX<Scalar> apply(const Eigen::Matrix2<Scalar>& G, const Eigen::VectorX<Scalar>& x) const;
+    Eigen::MatrixX<Scalar> getElementMatrix(const Eigen::Matrix2<Scalar>& G) const;
+
+private:
+    std::vector<QuadShapeFunctionFactorization> m_factorizations;
+    Eigen::MatrixX<Scalar> m_mass;
+    Eigen::MatrixX<Scalar> m_stiffness;
+    Eigen::MatrixX<Scalar> m_gradient;
+};
+} // namespace fem
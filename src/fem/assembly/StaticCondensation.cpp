@@ -0,0 +1,193 @@
+#include "fem/assembly/StaticCondensation.hpp"
+
+#include <cassert>
+
+#include "fem/basis/BasisFunctionIndexer.hpp"
+
+namespace fem
+{
+namespace
+{
+template<typename Scalar>
+Eigen::MatrixX<Scalar> extractBlock(const Eigen::MatrixX<Scalar>& A, const std::vector<uint32_t>& rows, const std::vector<uint32_t>& cols)
+{
+    return A(rows, cols);
+}
+
+template<typename Scalar>
+Eigen::MatrixX<Scalar> extractBlock(const Eigen::SparseMatrix<Scalar>& A, const std::vector<uint32_t>& rows, const std::vector<uint32_t>& cols)
+{
+    Eigen::MatrixX<Scalar> res(rows.size(), cols.size());
+    for (int j = 0; j < cols.size(); j++)
+    {
+        for (int i = 0; i < rows.size(); i++)
+        {
+            res(i, j) = A.coeff(rows[i], cols[j]);
+        }
+    }
+    return res;
+}
+
+/* A(condensedToGlobal, condensedToGlobal) - sum of the element contributions */
+template<typename Scalar, typename ElementCondensation>
+void buildCondensedMatrix(Eigen::MatrixX<Scalar>& res, const Eigen::MatrixX<Scalar>& A, const std::vector<uint32_t>& condensedToGlobal,
+                          const std::vector<int>& globalToCondensed, const std::vector<ElementCondensation>& elementCondensations,
+                          const std::vector<Eigen::MatrixX<Scalar>>& elementContributions)
+{
+    res = A(condensedToGlobal, condensedToGlobal);
+    for (int elementIdx = 0; elementIdx < elementCondensations.size(); elementIdx++)
+    {
+        const auto& boundaryIndices = elementCondensations[elementIdx].boundaryIndices;
+        const Eigen::MatrixX<Scalar>& contribution = elementContributions[elementIdx];
+        for (int j = 0; j < contribution.cols(); j++)
+        {
+            for (int i = 0; i < contribution.rows(); i++)
+            {
+                res(globalToCondensed[boundaryIndices[i]], globalToCondensed[boundaryIndices[j]]) -= contribution(i, j);
+            }
+        }
+    }
+}
+
+template<typename Scalar, typename ElementCondensation>
+void buildCondensedMatrix(Eigen::SparseMatrix<Scalar>& res, const Eigen::SparseMatrix<Scalar>& A, const std::vector<uint32_t>& condensedToGlobal,
+                          const std::vector<int>& globalToCondensed, const std::vector<ElementCondensation>& elementCondensations,
+                          const std::vector<Eigen::MatrixX<Scalar>>& elementContributions)
+{
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    for (int jj = 0; jj < A.outerSize(); jj++)
+    {
+        const int j = globalToCondensed[jj];
+        if (j < 0)
+        {
+            continue;
+        }
+        for (typename Eigen::SparseMatrix<Scalar>::InnerIterator it(A, jj); it; ++it)
+        {
+            const int i = globalToCondensed[it.row()];
+            if (i >= 0)
+            {
+                triplets.emplace_back(i, j, it.value());
+            }
+        }
+    }
+    for (int elementIdx = 0; elementIdx < elementCondensations.size(); elementIdx++)
+    {
+        const auto& boundaryIndices = elementCondensations[elementIdx].boundaryIndices;
+        const Eigen::MatrixX<Scalar>& contribution = elementContributions[elementIdx];
+        for (int j = 0; j < contribution.cols(); j++)
+        {
+            for (int i = 0; i < contribution.rows(); i++)
+            {
+                triplets.emplace_back(globalToCondensed[boundaryIndices[i]], globalToCondensed[boundaryIndices[j]], -contribution(i, j));
+            }
+        }
+    }
+    res.resize(condensedToGlobal.size(), condensedToGlobal.size());
+    res.setFromTriplets(triplets.begin(), triplets.end());
+}
+} // namespace
+
+template<typename MatrixType>
+StaticCondensation<MatrixType>::StaticCondensation(const FemContext& ctx, const MatrixType& stiffnessMatrix)
+{
+    const BasisFunctionIndexer indexer(ctx);
+    const uint32_t numOfBasisFunctions = indexer.getNumOfBasisFunctions();
+    assert(stiffnessMatrix.rows() == numOfBasisFunctions && stiffnessMatrix.cols() == numOfBasisFunctions);
+
+    m_globalToCondensed.assign(numOfBasisFunctions, -1);
+    for (uint32_t i = 0; i < numOfBasisFunctions; i++)
+    {
+        if (!std::holds_alternative<InternalBasisFunctionDescriptor>(indexer.getBasisFunctionDescriptor(i)))
+        {
+            m_globalToCondensed[i] = m_condensedToGlobal.size();
+            m_condensedToGlobal.push_back(i);
+        }
+    }
+
+    const Mesh& mesh = *ctx.mesh;
+    m_elementCondensations.resize(mesh.getNumOfElements());
+    std::vector<Eigen::MatrixX<Scalar>> elementContributions(mesh.getNumOfElements());
+    #pragma omp parallel for schedule(dynamic)
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        ElementCondensation& elementCondensation = m_elementCondensations[elementIdx];
+        for (uint32_t shapeFunctionIdx = 0; shapeFunctionIdx < indexer.getNumOfShapeFunctions(elementIdx); shapeFunctionIdx++)
+        {
+            const uint32_t basisFunctionIdx = indexer.getBasisFunctionIndex(elementIdx, shapeFunctionIdx);
+            if (m_globalToCondensed[basisFunctionIdx] < 0)
+            {
+                elementCondensation.internalIndices.push_back(basisFunctionIdx);
+            }
+            else
+            {
+                elementCondensation.boundaryIndices.push_back(basisFunctionIdx);
+            }
+        }
+        if (elementCondensation.internalIndices.empty())
+        {
+            continue;
+        }
+        const auto& internalIndices = elementCondensation.internalIndices;
+        const auto& boundaryIndices = elementCondensation.boundaryIndices;
+        elementCondensation.internalBlockLu.compute(extractBlock(stiffnessMatrix, internalIndices, internalIndices));
+        elementCondensation.internalToBoundary = elementCondensation.internalBlockLu.solve(extractBlock(stiffnessMatrix, internalIndices, boundaryIndices));
+        /* A_BI * A_II^-1 * A_IB, where A_BI = A_IB^T by symmetry */
+        elementContributions[elementIdx] = extractBlock(stiffnessMatrix, boundaryIndices, internalIndices) * elementCondensation.internalToBoundary;
+    }
+
+    buildCondensedMatrix(m_condensedStiffnessMatrix, stiffnessMatrix, m_condensedToGlobal, m_globalToCondensed, m_elementCondensations, elementContributions);
+}
+
+template<typename MatrixType>
+typename StaticCondensation<MatrixType>::VectorType StaticCondensation<MatrixType>::condenseLoadVector(const VectorType& loadVector) const
+{
+    assert(loadVector.size() == m_globalToCondensed.size());
+    VectorType res = loadVector(m_condensedToGlobal);
+    for (const ElementCondensation& elementCondensation : m_elementCondensations)
+    {
+        if (elementCondensation.internalIndices.empty())
+        {
+            continue;
+        }
+        /* A_BI * A_II^-1 = (A_II^-1 * A_IB)^T */
+        const VectorType contribution = elementCondensation.internalToBoundary.transpose() * loadVector(elementCondensation.internalIndices);
+        for (int i = 0; i < contribution.size(); i++)
+        {
+            res(m_globalToCondensed[elementCondensation.boundaryIndices[i]]) -= contribution(i);
+        }
+    }
+    return res;
+}
+
+template<typename MatrixType>
+typename StaticCondensation<MatrixType>::VectorType StaticCondensation<MatrixType>::expandSolution(const VectorType& condensedSolution, const VectorType& loadVector) const
+{
+    assert(condensedSolution.size() == m_condensedToGlobal.size());
+    assert(loadVector.size() == m_globalToCondensed.size());
+    VectorType res(m_globalToCondensed.size());
+    res(m_condensedToGlobal) = condensedSolution;
+    #pragma omp parallel for schedule(dynamic)
+    for (int elementIdx = 0; elementIdx < m_elementCondensations.size(); elementIdx++)
+    {
+        const ElementCondensation& elementCondensation = m_elementCondensations[elementIdx];
+        if (elementCondensation.internalIndices.empty())
+        {
+            continue;
+        }
+        const VectorType boundarySolution = res(elementCondensation.boundaryIndices);
+        res(elementCondensation.internalIndices) = elementCondensation.internalBlockLu.solve(loadVector(elementCondensation.internalIndices))
+                                                   - elementCondensation.internalToBoundary * boundarySolution;
+    }
+    return res;
+}
+
+template class StaticCondensation<MatrixXmpq>;
+template class StaticCondensation<SparseMatrixXmpq>;
+template class StaticCondensation<MatrixXmpf>;
+template class StaticCondensation<Eigen::SparseMatrix<mpf_class>>;
+template class StaticCondensation<Eigen::MatrixXd>;
+template class StaticCondensation<Eigen::SparseMatrix<double>>;
+template class StaticCondensation<Eigen::MatrixX<long double>>;
+template class StaticCondensation<Eigen::SparseMatrix<long double>>;
+} // namespace fem
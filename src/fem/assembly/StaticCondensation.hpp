@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "fem/basis/FemContext.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/*
+ * Static condensation of the internal basis functions. An internal basis function is supported on a single element,
+ * so with the stiffness matrix split into the internal (I) and the nodal and side (B) basis functions of each element,
+ * the internal coefficients can be eliminated element by element:
+ *     S = A_BB - sum_e A_BI,e * A_II,e^-1 * A_IB,e
+ *     g = b_B  - sum_e A_BI,e * A_II,e^-1 * b_I,e
+ * After solving S*x_B = g the internal coefficients are recovered by x_I,e = A_II,e^-1 * (b_I,e - A_IB,e * x_B).
+ *
+ * MatrixType is a dense or sparse matrix of mpq_class, mpf_class, double or long double. The condensed basis consists
+ * of the nodal and side basis functions in their global order, so the first nodal basis function stays first.
+ */
+template<typename MatrixType>
+class StaticCondensation
+{
+public:
+    using Scalar = typename MatrixType::Scalar;
+    using VectorType = Eigen::VectorX<Scalar>;
+
+    StaticCondensation(const FemContext& ctx, const MatrixType& stiffnessMatrix);
+
+    const MatrixType& getCondensedStiffnessMatrix() const { return m_condensedStiffnessMatrix; }
+    /* Index in the condensed basis of each basis function, -1 for the internal ones */
+    const std::vector<int>& getGlobalToCondensed() const { return m_globalToCondensed; }
+    VectorType condenseLoadVector(const VectorType& loadVector) const;
+    /* Coefficients of all the basis functions from those of the nodal and side basis functions */
+    VectorType expandSolution(const VectorType& condensedSolution, const VectorType& loadVector) const;
+
+private:
+    struct ElementCondensation
+    {
+        std::vector<uint32_t> internalIndices;
+        std::vector<uint32_t> boundaryIndices;
+        Eigen::PartialPivLU<Eigen::MatrixX<Scalar>> internalBlockLu;
+        /* A_II^-1 * A_IB */
+        Eigen::MatrixX<Scalar> internalToBoundary;
+    };
+
+private:
+    std::vector<uint32_t> m_condensedToGlobal;
+    std::vector<int> m_globalToCondensed;
+    std::vector<ElementCondensation> m_elementCondensations;
+    MatrixType m_condensedStiffnessMatrix;
+};
+} // namespace fem
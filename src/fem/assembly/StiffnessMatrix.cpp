@@ -2,50 +2,235 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <map>
 #include <tuple>
-#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-#include <boost/functional/hash.hpp>
-
+#include "fem/assembly/QuadStiffnessKernel.hpp"
 #include "fem/basis/BasisFunctionFactory.hpp"
 #include "fem/basis/BasisFunctionIndexer.hpp"
 #include "fem/basis/ShapeFunctionIndexer.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
 namespace
 {
+/* The reference integrals are always computed exactly and rounded to Scalar only once they are cached */
+template<typename Scalar>
 struct StiffnessMatrixAssembler
 {
-    using ShapeFunctionDerivativePair = std::tuple<uint32_t, char, uint32_t, char>;
-    using ShapeFunctionIntegralCache = std::unordered_map<ShapeFunctionDerivativePair, mpq_class, boost::hash<ShapeFunctionDerivativePair>>;
+    /* Integrals of the products of the partial derivatives of two shape functions over the reference element */
+    struct GradientProductIntegrals
+    {
+        Scalar xx;
+        Scalar xy;
+        Scalar yx;
+        Scalar yy;
+    };
 
     const FemContext& ctx;
     const ShapeFunctionFactory& shapeFunctionFactory;
     BasisFunctionIndexer basisFunctionIndexer;
     ShapeFunctionIndexer shapeFunctionIndexer;
-    MatrixXmpq stiffnessMatrix;
-    ShapeFunctionIntegralCache integralCache[2]; // one for triangles and one for quads
+    /* Degree of the matrix being enriched, 0 when assembling from scratch */
+    uint32_t previousP;
+    /* Only pairs of shape functions of which at least one is new compared to degree previousP are integrated */
+    std::vector<bool> isNewShapeFunction[2];
+    /* Packed upper triangular in row-major order of (shapeFnIdx1, shapeFnIdx2), one for triangles and one for quads */
+    std::vector<GradientProductIntegrals> integralCache[2];
+    /*
+     * The element stiffness matrix without side orientation signs depends only on the element type and
+     * G = det(A) A^-1 A^-T, so it is computed once per distinct (type, G). The blocks are packed upper triangular.
+     */
+    std::vector<uint32_t> similarityClassOfElement;
+    std::vector<std::vector<Scalar>> elementBlocks;
 
-    StiffnessMatrixAssembler(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory);
-    void assemble();
+    StiffnessMatrixAssembler(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, uint32_t previousP = 0);
+    Eigen::MatrixX<Scalar> assembleDense();
+    Eigen::SparseMatrix<Scalar> assembleSparse();
+    Eigen::MatrixX<Scalar> enrichDense(const Eigen::MatrixX<Scalar>& previousStiffnessMatrix);
+    Eigen::SparseMatrix<Scalar> enrichSparse(const Eigen::SparseMatrix<Scalar>& previousStiffnessMatrix);
+    void addElementContributions(Eigen::MatrixX<Scalar>& stiffnessMatrix);
+    void addElementContributions(std::vector<Eigen::Triplet<Scalar>>& triplets);
+    uint32_t getNumOfNewShapeFunctions(ElementType elementType) const;
+    void precomputeIntegrals();
     void precomputeIntegrals(ElementType elementType);
-    void assembleElement(Mesh::ElementIndex elementIdx);
-    void symmetrize();
+    void precomputeElementBlocks();
+    /* Calls addEntry(i, j, value) with i <= j for every upper triangular contribution of the element */
+    template<typename AddEntryFn>
+    void assembleElement(Mesh::ElementIndex elementIdx, AddEntryFn&& addEntry);
+    /* Calls visitEntry(i, j, blockIdx, isNegated) for the same contributions, blockIdx indexing the element block */
+    template<typename VisitEntryFn>
+    void visitElementEntries(Mesh::ElementIndex elementIdx, VisitEntryFn&& visitEntry) const;
 };
 
-StiffnessMatrixAssembler::StiffnessMatrixAssembler(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory)
+template<typename Scalar>
+StiffnessMatrixAssembler<Scalar>::StiffnessMatrixAssembler(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, uint32_t previousP)
     : ctx(ctx)
     , shapeFunctionFactory(shapeFunctionFactory)
     , basisFunctionIndexer(BasisFunctionIndexer(ctx))
     , shapeFunctionIndexer(ShapeFunctionIndexer(ctx.p, ctx.polynomialSpaceType))
+    , previousP(previousP)
 {
-    const uint32_t numOfBasisFunctions = basisFunctionIndexer.getNumOfBasisFunctions();
-    stiffnessMatrix = MatrixXmpq(numOfBasisFunctions, numOfBasisFunctions);
+    assert(previousP < ctx.p);
+    for (const ElementType elementType : {ElementType_Triangle, ElementType_Parallelogram})
+    {
+        std::unordered_set<ShapeFunctionDescriptor> previousDescriptors;
+        if (previousP > 0)
+        {
+            const ShapeFunctionIndexer previousShapeFunctionIndexer(previousP, ctx.polynomialSpaceType);
+            for (int shapeFnIdx = 0; shapeFnIdx < previousShapeFunctionIndexer.getNumOfShapeFunctions(elementType); shapeFnIdx++)
+            {
+                previousDescriptors.insert(previousShapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx));
+            }
+        }
+        const uint32_t numOfShapeFunctions = shapeFunctionIndexer.getNumOfShapeFunctions(elementType);
+        isNewShapeFunction[elementType].resize(numOfShapeFunctions);
+        for (int shapeFnIdx = 0; shapeFnIdx < numOfShapeFunctions; shapeFnIdx++)
+        {
+            const auto desc = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx);
+            isNewShapeFunction[elementType][shapeFnIdx] = !previousDescriptors.contains(desc);
+        }
+    }
+}
+
+template<typename Scalar>
+Eigen::MatrixX<Scalar> StiffnessMatrixAssembler<Scalar>::assembleDense()
+{
+    precomputeIntegrals();
+    precomputeElementBlocks();
+    const uint32_t dim = basisFunctionIndexer.getNumOfBasisFunctions();
+    Eigen::MatrixX<Scalar> res = Eigen::MatrixX<Scalar>::Zero(dim, dim);
+    addElementContributions(res);
+    return res;
+}
+
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> StiffnessMatrixAssembler<Scalar>::assembleSparse()
+{
+    precomputeIntegrals();
+    precomputeElementBlocks();
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    addElementContributions(triplets);
+    const uint32_t dim = basisFunctionIndexer.getNumOfBasisFunctions();
+    Eigen::SparseMatrix<Scalar> res(dim, dim);
+    res.setFromTriplets(triplets.begin(), triplets.end()); // duplicates are summed
+    return res;
+}
+
+template<typename Scalar>
+Eigen::MatrixX<Scalar> StiffnessMatrixAssembler<Scalar>::enrichDense(const Eigen::MatrixX<Scalar>& previousStiffnessMatrix)
+{
+    precomputeIntegrals();
+    precomputeElementBlocks();
+    const std::vector<uint32_t> previousToCurrent = getSubToSuperBasisFunctionIndices(ctx, previousP);
+    assert(previousStiffnessMatrix.rows() == previousToCurrent.size() && previousStiffnessMatrix.cols() == previousToCurrent.size());
+    const uint32_t dim = basisFunctionIndexer.getNumOfBasisFunctions();
+    Eigen::MatrixX<Scalar> res = Eigen::MatrixX<Scalar>::Zero(dim, dim);
+    for (int j = 0; j < previousToCurrent.size(); j++)
+    {
+        for (int i = 0; i < previousToCurrent.size(); i++)
+        {
+            res(previousToCurrent[i], previousToCurrent[j]) = previousStiffnessMatrix(i,j);
+        }
+    }
+    addElementContributions(res);
+    return res;
+}
+
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> StiffnessMatrixAssembler<Scalar>::enrichSparse(const Eigen::SparseMatrix<Scalar>& previousStiffnessMatrix)
+{
+    precomputeIntegrals();
+    precomputeElementBlocks();
+    const std::vector<uint32_t> previousToCurrent = getSubToSuperBasisFunctionIndices(ctx, previousP);
+    assert(previousStiffnessMatrix.rows() == previousToCurrent.size() && previousStiffnessMatrix.cols() == previousToCurrent.size());
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    triplets.reserve(previousStiffnessMatrix.nonZeros());
+    for (int j = 0; j < previousStiffnessMatrix.outerSize(); j++)
+    {
+        for (typename Eigen::SparseMatrix<Scalar>::InnerIterator it(previousStiffnessMatrix, j); it; ++it)
+        {
+            triplets.emplace_back(previousToCurrent[it.row()], previousToCurrent[j], it.value());
+        }
+    }
+    addElementContributions(triplets);
+    const uint32_t dim = basisFunctionIndexer.getNumOfBasisFunctions();
+    Eigen::SparseMatrix<Scalar> res(dim, dim);
+    res.setFromTriplets(triplets.begin(), triplets.end());
+    return res;
+}
+
+/* Adds the upper triangle contributions and then mirrors the whole upper triangle to the lower one */
+template<typename Scalar>
+void StiffnessMatrixAssembler<Scalar>::addElementContributions(Eigen::MatrixX<Scalar>& stiffnessMatrix)
+{
+    /* Elements of the same color share no basis functions, so they write to disjoint entries. The colors are
+     * processed in a fixed order which keeps the floating-point summation order independent of the threads. */
+    for (const auto& elementIdxs : ctx.mesh->getElementColors())
+    {
+        #pragma omp parallel for schedule(dynamic)
+        for (int k = 0; k < elementIdxs.size(); k++)
+        {
+            assembleElement(elementIdxs[k], [&stiffnessMatrix](uint32_t i, uint32_t j, Scalar&& value)
+            {
+                stiffnessMatrix(i,j) += value;
+            });
+        }
+    }
+    const uint32_t dim = stiffnessMatrix.rows();
+    for (int j = 0; j < dim; j++)
+    {
+        for (int i = j + 1; i < dim; i++)
+        {
+            stiffnessMatrix(i,j) = stiffnessMatrix(j,i);
+        }
+    }
+}
+
+/* Appends the contributions of both triangles */
+template<typename Scalar>
+void StiffnessMatrixAssembler<Scalar>::addElementContributions(std::vector<Eigen::Triplet<Scalar>>& triplets)
+{
+    const Mesh& mesh = *ctx.mesh;
+    /* Every element emits exactly n^2 - n_previous^2 triplets into its own slice so that the elements can be
+     * assembled in parallel while the triplet order stays the same as in the serial loop */
+    std::vector<size_t> tripletOffsets(mesh.getNumOfElements() + 1, triplets.size());
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        const ElementType elementType = mesh.getElement(elementIdx).getElementType();
+        const size_t numOfShapeFunctions = shapeFunctionIndexer.getNumOfShapeFunctions(elementType);
+        const size_t numOfPreviousShapeFunctions = numOfShapeFunctions - getNumOfNewShapeFunctions(elementType);
+        tripletOffsets[elementIdx + 1] = tripletOffsets[elementIdx] + numOfShapeFunctions * numOfShapeFunctions - numOfPreviousShapeFunctions * numOfPreviousShapeFunctions;
+    }
+    triplets.resize(tripletOffsets.back());
+    #pragma omp parallel for schedule(dynamic)
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        size_t tripletIdx = tripletOffsets[elementIdx];
+        assembleElement(elementIdx, [&triplets, &tripletIdx](uint32_t i, uint32_t j, Scalar&& value)
+        {
+            if (i != j)
+            {
+                triplets[tripletIdx++] = Eigen::Triplet<Scalar>(j, i, value);
+            }
+            triplets[tripletIdx++] = Eigen::Triplet<Scalar>(i, j, std::move(value));
+        });
+        assert(tripletIdx == tripletOffsets[elementIdx + 1]);
+    }
 }
 
-void StiffnessMatrixAssembler::assemble()
+template<typename Scalar>
+uint32_t StiffnessMatrixAssembler<Scalar>::getNumOfNewShapeFunctions(ElementType elementType) const
+{
+    return std::count(isNewShapeFunction[elementType].begin(), isNewShapeFunction[elementType].end(), true);
+}
+
+template<typename Scalar>
+void StiffnessMatrixAssembler<Scalar>::precomputeIntegrals()
 {
     const Mesh& mesh = *ctx.mesh;
     if (mesh.containsQuadrilateral())
@@ -56,128 +241,238 @@ void StiffnessMatrixAssembler::assemble()
     {
         precomputeIntegrals(ElementType_Triangle);
     }
-    for (int elementIdx = 0; elementIdx < ctx.mesh->getNumOfElements(); elementIdx++)
+}
+
+template<typename Scalar>
+void StiffnessMatrixAssembler<Scalar>::precomputeElementBlocks()
+{
+    const Mesh& mesh = *ctx.mesh;
+    using SimilarityKey = std::tuple<ElementType, mpq_class, mpq_class, mpq_class>; // G is symmetric
+    std::map<SimilarityKey, uint32_t> similarityClasses;
+    std::vector<std::pair<ElementType, Matrix2mpq>> classRepresentatives;
+    similarityClassOfElement.resize(mesh.getNumOfElements());
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        const ElementType elementType = mesh.getElement(elementIdx).getElementType();
+        const ElementGeometry& geometry = mesh.getElementGeometry(elementIdx);
+        const Matrix2mpq G = geometry.detA * geometry.M;
+        const auto [it, inserted] = similarityClasses.emplace(SimilarityKey(elementType, G(0,0), G(0,1), G(1,1)), classRepresentatives.size());
+        if (inserted)
+        {
+            classRepresentatives.emplace_back(elementType, G);
+        }
+        similarityClassOfElement[elementIdx] = it->second;
+    }
+
+    elementBlocks.resize(classRepresentatives.size());
+    #pragma omp parallel for schedule(dynamic)
+    for (int classIdx = 0; classIdx < classRepresentatives.size(); classIdx++)
     {
-        assembleElement(elementIdx);
+        const ElementType elementType = classRepresentatives[classIdx].first;
+        const Eigen::Matrix2<Scalar> G = classRepresentatives[classIdx].second.unaryExpr([](const mpq_class& x) { return convertRational<Scalar>(x); });
+        const std::vector<GradientProductIntegrals>& cache = integralCache[elementType];
+        std::vector<Scalar>& block = elementBlocks[classIdx];
+        block.reserve(cache.size());
+        for (const GradientProductIntegrals& integrals : cache)
+        {
+            Scalar integral = G(0,0) * integrals.xx;
+            integral += G(0,1) * integrals.xy;
+            integral += G(1,0) * integrals.yx;
+            integral += G(1,1) * integrals.yy;
+            block.push_back(std::move(integral));
+        }
     }
-    symmetrize();
 }
 
-void StiffnessMatrixAssembler::assembleElement(Mesh::ElementIndex elementIdx)
+template<typename Scalar>
+template<typename AddEntryFn>
+void StiffnessMatrixAssembler<Scalar>::assembleElement(Mesh::ElementIndex elementIdx, AddEntryFn&& addEntry)
+{
+    const std::vector<Scalar>& block = elementBlocks[similarityClassOfElement[elementIdx]];
+    visitElementEntries(elementIdx, [&block, &addEntry](uint32_t i, uint32_t j, size_t blockIdx, bool isNegated)
+    {
+        Scalar integral = block[blockIdx];
+        if (isNegated)
+        {
+            integral = -integral;
+        }
+        addEntry(i, j, std::move(integral));
+    });
+}
+
+template<typename Scalar>
+template<typename VisitEntryFn>
+void StiffnessMatrixAssembler<Scalar>::visitElementEntries(Mesh::ElementIndex elementIdx, VisitEntryFn&& visitEntry) const
 {
     const Mesh& mesh = *ctx.mesh;
-    const Element& element = mesh.getElement(elementIdx);
-    const ElementType elementType = element.getElementType();
-    const AffineMap F = element.getReferenceElementMap();
-    const Matrix2mpq& A = F.A;
-    const Matrix2mpq Ainv = A.inverse();
-    const Matrix2mpq AinvT = Ainv.transpose();
-    const Matrix2mpq M = Ainv * AinvT;
-    const mpq_class detA = A.determinant();
+    const ElementType elementType = mesh.getElement(elementIdx).getElementType();
     const uint32_t numOfShapeFunctions = shapeFunctionIndexer.getNumOfShapeFunctions(elementType);
-    for (int shapeFnIdx1 = 0; shapeFnIdx1 < numOfShapeFunctions; shapeFnIdx1++)
+    std::vector<uint32_t> basisFnIdxs(numOfShapeFunctions);
+    std::vector<bool> isSignFlipped(numOfShapeFunctions, false);
+    for (int shapeFnIdx = 0; shapeFnIdx < numOfShapeFunctions; shapeFnIdx++)
     {
-        const auto desc1 = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx1);
-        const uint32_t basisFnIdx1 = basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFnIdx1);
-        for (int shapeFnIdx2 = shapeFnIdx1; shapeFnIdx2 < numOfShapeFunctions; shapeFnIdx2++)
+        basisFnIdxs[shapeFnIdx] = basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFnIdx);
+        const auto desc = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx);
+        if (const auto* descp = std::get_if<SideShapeFunctionDescriptor>(&desc))
         {
-            const auto desc2 = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx2);
-            const uint32_t basisFnIdx2 = basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFnIdx2);
-
-            const auto key_xx = std::make_tuple(shapeFnIdx1, 'x', shapeFnIdx2, 'x');
-            const auto key_xy = std::make_tuple(shapeFnIdx1, 'x', shapeFnIdx2, 'y');
-            const auto key_yx = std::make_tuple(shapeFnIdx1, 'y', shapeFnIdx2, 'x');
-            const auto key_yy = std::make_tuple(shapeFnIdx1, 'y', shapeFnIdx2, 'y');
-
-            mpq_class integral = 0;
-            integral += M(0,0) * integralCache[elementType].at(key_xx);
-            integral += M(0,1) * integralCache[elementType].at(key_xy);
-            integral += M(1,0) * integralCache[elementType].at(key_yx);
-            integral += M(1,1) * integralCache[elementType].at(key_yy);
-            integral *= detA;
+            const auto adjacentElementIdx = mesh.getIndexOfAdjacentElement(elementIdx, descp->sideIdx);
+            isSignFlipped[shapeFnIdx] = adjacentElementIdx.has_value() && elementIdx < adjacentElementIdx.value() && descp->k % 2 != 0;
+        }
+    }
 
-            if (const auto* descp1 = std::get_if<SideShapeFunctionDescriptor>(&desc1))
-            {
-                const auto adjacentElementIdx = mesh.getIndexOfAdjacentElement(elementIdx, descp1->sideIdx);
-                if (adjacentElementIdx.has_value() && elementIdx < adjacentElementIdx.value() && descp1->k % 2 != 0)
-                {
-                    integral *= -1;
-                }
-            }
-            if (const auto* descp2 = std::get_if<SideShapeFunctionDescriptor>(&desc2))
+    size_t blockIdx = 0;
+    for (int shapeFnIdx1 = 0; shapeFnIdx1 < numOfShapeFunctions; shapeFnIdx1++)
+    {
+        for (int shapeFnIdx2 = shapeFnIdx1; shapeFnIdx2 < numOfShapeFunctions; shapeFnIdx2++, blockIdx++)
+        {
+            if (!isNewShapeFunction[elementType][shapeFnIdx1] && !isNewShapeFunction[elementType][shapeFnIdx2])
             {
-                const auto adjacentElementIdx = mesh.getIndexOfAdjacentElement(elementIdx, descp2->sideIdx);
-                if (adjacentElementIdx.has_value() && elementIdx < adjacentElementIdx.value() && descp2->k % 2 != 0)
-                {
-                    integral *= -1;
-                }
+                continue;
             }
-
-            const uint32_t i = std::min(basisFnIdx1, basisFnIdx2);
-            const uint32_t j = std::max(basisFnIdx1, basisFnIdx2);
-            stiffnessMatrix(i,j) += std::move(integral);
+            const uint32_t i = std::min(basisFnIdxs[shapeFnIdx1], basisFnIdxs[shapeFnIdx2]);
+            const uint32_t j = std::max(basisFnIdxs[shapeFnIdx1], basisFnIdxs[shapeFnIdx2]);
+            visitEntry(i, j, blockIdx, isSignFlipped[shapeFnIdx1] != isSignFlipped[shapeFnIdx2]);
         }
     }
 }
 
-void StiffnessMatrixAssembler::symmetrize()
+template<typename Scalar>
+void StiffnessMatrixAssembler<Scalar>::precomputeIntegrals(ElementType elementType)
 {
-    const uint32_t dim = stiffnessMatrix.rows();
-    for (int j = 0; j < dim; j++)
+    std::vector<GradientProductIntegrals>& cache = integralCache[elementType];
+    const ReferenceMomentTable& moments = shapeFunctionFactory.getReferenceMomentTable(elementType);
+    const uint32_t numOfShapeFunctions = shapeFunctionIndexer.getNumOfShapeFunctions(elementType);
+    const std::vector<bool>& isNew = isNewShapeFunction[elementType];
+    /* (packed index, shapeFnIdx1, shapeFnIdx2) of the pairs to integrate, the others are left zero */
+    std::vector<std::tuple<size_t, uint32_t, uint32_t>> shapeFunctionPairs;
+    size_t packedIdx = 0;
+    for (uint32_t shapeFnIdx1 = 0; shapeFnIdx1 < numOfShapeFunctions; shapeFnIdx1++)
     {
-        for (int i = j + 1; i < dim; i++)
+        for (uint32_t shapeFnIdx2 = shapeFnIdx1; shapeFnIdx2 < numOfShapeFunctions; shapeFnIdx2++, packedIdx++)
         {
-            stiffnessMatrix(i,j) = stiffnessMatrix(j,i);
+            if (isNew[shapeFnIdx1] || isNew[shapeFnIdx2])
+            {
+                shapeFunctionPairs.emplace_back(packedIdx, shapeFnIdx1, shapeFnIdx2);
+            }
         }
     }
-}
 
-void StiffnessMatrixAssembler::precomputeIntegrals(ElementType elementType)
-{
-    auto& cache = integralCache[elementType];
-    const uint32_t numOfShapeFunctions = shapeFunctionIndexer.getNumOfShapeFunctions(elementType);
-    std::vector<ShapeFunctionDerivativePair> derivativePairs;
-    for (int shapeFnIdx1 = 0; shapeFnIdx1 < numOfShapeFunctions; shapeFnIdx1++)
+    cache.assign(packedIdx, GradientProductIntegrals{0, 0, 0, 0});
+    if (elementType == ElementType_Parallelogram)
     {
-        for (int shapeFnIdx2 = shapeFnIdx1; shapeFnIdx2 < numOfShapeFunctions; shapeFnIdx2++)
+        /* The quad integrals are products of exact 1D integrals */
+        const QuadStiffnessKernel<mpq_class> quadKernel(ctx.p, ctx.polynomialSpaceType, shapeFunctionFactory);
+        #pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < shapeFunctionPairs.size(); i++)
         {
-            const auto key_xx = std::make_tuple(shapeFnIdx1, 'x', shapeFnIdx2, 'x');
-            const auto key_xy = std::make_tuple(shapeFnIdx1, 'x', shapeFnIdx2, 'y');
-            const auto key_yx = std::make_tuple(shapeFnIdx1, 'y', shapeFnIdx2, 'x');
-            const auto key_yy = std::make_tuple(shapeFnIdx1, 'y', shapeFnIdx2, 'y');
-            cache.emplace(key_xx, 0);
-            cache.emplace(key_xy, 0);
-            cache.emplace(key_yx, 0);
-            cache.emplace(key_yy, 0);
-            derivativePairs.push_back(key_xx);
-            derivativePairs.push_back(key_xy);
-            derivativePairs.push_back(key_yx);
-            derivativePairs.push_back(key_yy);
+            const auto [cacheIdx, shapeFnIdx1, shapeFnIdx2] = shapeFunctionPairs[i];
+            const auto quadIntegrals = quadKernel.getReferenceIntegrals(shapeFnIdx1, shapeFnIdx2);
+            GradientProductIntegrals& integrals = cache[cacheIdx];
+            integrals.xx = convertRational<Scalar>(quadIntegrals.xx);
+            integrals.xy = convertRational<Scalar>(quadIntegrals.xy);
+            integrals.yx = convertRational<Scalar>(quadIntegrals.yx);
+            integrals.yy = convertRational<Scalar>(quadIntegrals.yy);
         }
+        return;
     }
-
-    #pragma omp parallel for schedule(static,1)
-    for (int i = 0; i < derivativePairs.size(); i++)
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < shapeFunctionPairs.size(); i++)
     {
-        const auto& derivativePair = derivativePairs[i];
-        const uint32_t shapeFnIdx1 = std::get<0>(derivativePair);
-        const char var1 = std::get<1>(derivativePair);
-        const uint32_t shapeFnIdx2 = std::get<2>(derivativePair);
-        const char var2 = std::get<3>(derivativePair);
+        const auto [cacheIdx, shapeFnIdx1, shapeFnIdx2] = shapeFunctionPairs[i];
         const auto desc1 = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx1);
         const auto desc2 = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx2);
-        const Polynomial2D& shapeFn1D = shapeFunctionFactory.getShapeFunctionDerivative(elementType, desc1, var1);
-        const Polynomial2D& shapeFn2D = shapeFunctionFactory.getShapeFunctionDerivative(elementType, desc2, var2);
-        cache.at(derivativePair) = integrateOverReferenceElement(shapeFn1D * shapeFn2D, elementType);
+        const Polynomial2D& shapeFn1Dx = shapeFunctionFactory.getShapeFunctionDerivative(elementType, desc1, 'x');
+        const Polynomial2D& shapeFn1Dy = shapeFunctionFactory.getShapeFunctionDerivative(elementType, desc1, 'y');
+        const Polynomial2D& shapeFn2Dx = shapeFunctionFactory.getShapeFunctionDerivative(elementType, desc2, 'x');
+        const Polynomial2D& shapeFn2Dy = shapeFunctionFactory.getShapeFunctionDerivative(elementType, desc2, 'y');
+        GradientProductIntegrals& integrals = cache[cacheIdx];
+        integrals.xx = convertRational<Scalar>(integrateProductOverReferenceElement(shapeFn1Dx, shapeFn2Dx, moments));
+        integrals.xy = convertRational<Scalar>(integrateProductOverReferenceElement(shapeFn1Dx, shapeFn2Dy, moments));
+        integrals.yx = convertRational<Scalar>(integrateProductOverReferenceElement(shapeFn1Dy, shapeFn2Dx, moments));
+        integrals.yy = convertRational<Scalar>(integrateProductOverReferenceElement(shapeFn1Dy, shapeFn2Dy, moments));
     }
 }
 } // namespace
 
-MatrixXmpq assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory)
+template<typename Scalar>
+Eigen::MatrixX<Scalar> assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory)
+{
+    StiffnessMatrixAssembler<Scalar> assembler(ctx, shapeFunctionFactory);
+    return assembler.assembleDense();
+}
+
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> assembleSparseStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory)
+{
+    StiffnessMatrixAssembler<Scalar> assembler(ctx, shapeFunctionFactory);
+    return assembler.assembleSparse();
+}
+
+template<typename Scalar>
+Eigen::MatrixX<Scalar> enrichStiffnessMatrix(const FemContext& ctx, const Eigen::MatrixX<Scalar>& stiffnessMatrix, const ShapeFunctionFactory& shapeFunctionFactory)
+{
+    assert(ctx.p >= 2);
+    StiffnessMatrixAssembler<Scalar> assembler(ctx, shapeFunctionFactory, ctx.p - 1);
+    return assembler.enrichDense(stiffnessMatrix);
+}
+
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> enrichStiffnessMatrix(const FemContext& ctx, const Eigen::SparseMatrix<Scalar>& stiffnessMatrix, const ShapeFunctionFactory& shapeFunctionFactory)
+{
+    assert(ctx.p >= 2);
+    StiffnessMatrixAssembler<Scalar> assembler(ctx, shapeFunctionFactory, ctx.p - 1);
+    return assembler.enrichSparse(stiffnessMatrix);
+}
+
+ModularStiffnessMatrixAssembler::ModularStiffnessMatrixAssembler(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory)
 {
-    StiffnessMatrixAssembler assembler(ctx, shapeFunctionFactory);
-    assembler.assemble();
-    return std::move(assembler.stiffnessMatrix);
+    StiffnessMatrixAssembler<mpq_class> assembler(ctx, shapeFunctionFactory);
+    assembler.precomputeIntegrals();
+    assembler.precomputeElementBlocks();
+    m_numOfBasisFunctions = assembler.basisFunctionIndexer.getNumOfBasisFunctions();
+    std::vector<size_t> blockOffsets;
+    for (std::vector<mpq_class>& block : assembler.elementBlocks)
+    {
+        blockOffsets.push_back(m_blockEntries.size());
+        std::move(block.begin(), block.end(), std::back_inserter(m_blockEntries));
+    }
+    const Mesh& mesh = *ctx.mesh;
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        const size_t blockOffset = blockOffsets[assembler.similarityClassOfElement[elementIdx]];
+        assembler.visitElementEntries(elementIdx, [this, blockOffset](uint32_t i, uint32_t j, size_t blockIdx, bool isNegated)
+        {
+            m_entries.push_back(Entry{i, j, blockOffset + blockIdx, isNegated});
+            if (i != j)
+            {
+                m_entries.push_back(Entry{j, i, blockOffset + blockIdx, isNegated});
+            }
+        });
+    }
+}
+
+std::optional<ModularSparseMatrix> ModularStiffnessMatrixAssembler::assemble(uint64_t prime) const
+{
+    std::vector<uint64_t> blockEntries(m_blockEntries.size());
+    for (size_t idx = 0; idx < m_blockEntries.size(); idx++)
+    {
+        const std::optional<uint64_t> value = reduceRational(m_blockEntries[idx], prime);
+        if (!value)
+        {
+            return std::nullopt;
+        }
+        blockEntries[idx] = *value;
+    }
+    std::vector<Eigen::Triplet<uint64_t>> triplets(m_entries.size());
+    for (size_t idx = 0; idx < m_entries.size(); idx++)
+    {
+        const Entry& entry = m_entries[idx];
+        const uint64_t value = blockEntries[entry.blockIdx];
+        triplets[idx] = Eigen::Triplet<uint64_t>(entry.row, entry.col, entry.isNegated ? subMod(0, value, prime) : value);
+    }
+    ModularSparseMatrix res(m_numOfBasisFunctions, m_numOfBasisFunctions);
+    res.setFromTriplets(triplets.begin(), triplets.end(), [prime](uint64_t a, uint64_t b) { return addMod(a, b, prime); });
+    return res;
 }
 
 MatrixXmpq assembleStiffnessMatrix(const FemContext& ctx)
@@ -220,24 +515,227 @@ MatrixXmpq assembleStiffnessMatrix(const FemContext& ctx)
     return res;
 }
 
-MatrixXmpq extractSubStiffnessMatrix(const FemContext& ctx, const MatrixXmpq& stiffnessMatrix, uint32_t p)
+template<typename Scalar>
+Eigen::MatrixX<Scalar> extractSubStiffnessMatrix(const FemContext& ctx, const Eigen::MatrixX<Scalar>& stiffnessMatrix, uint32_t p)
 {
-    assert(p >= 1 && p <= ctx.p);
-    const BasisFunctionIndexer superBasisFunctionIndexer(ctx);
-    const BasisFunctionIndexer subBasisFunctionIndexer(FemContext(ctx.mesh, p, ctx.polynomialSpaceType));
-    const uint32_t numOfBasisFunctions = subBasisFunctionIndexer.getNumOfBasisFunctions();
-    MatrixXmpq res(numOfBasisFunctions, numOfBasisFunctions);
+    const std::vector<uint32_t> subToSuperIndex = getSubToSuperBasisFunctionIndices(ctx, p);
+    if (ctx.basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        return stiffnessMatrix.topLeftCorner(subToSuperIndex.size(), subToSuperIndex.size());
+    }
+    return stiffnessMatrix(subToSuperIndex, subToSuperIndex);
+}
+
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> extractSubStiffnessMatrix(const FemContext& ctx, const Eigen::SparseMatrix<Scalar>& stiffnessMatrix, uint32_t p)
+{
+    const std::vector<uint32_t> subToSuperIndex = getSubToSuperBasisFunctionIndices(ctx, p);
+    const uint32_t numOfBasisFunctions = subToSuperIndex.size();
+    if (ctx.basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        return stiffnessMatrix.topLeftCorner(numOfBasisFunctions, numOfBasisFunctions);
+    }
+    std::vector<int> superToSubIndex(stiffnessMatrix.rows(), -1);
     for (int i = 0; i < numOfBasisFunctions; i++)
     {
-        const BasisFunctionDescriptor desc_i = subBasisFunctionIndexer.getBasisFunctionDescriptor(i);
-        const int ii = superBasisFunctionIndexer.getBasisFunctionIndex(desc_i);
-        for (int j = 0; j < numOfBasisFunctions; j++)
+        superToSubIndex[subToSuperIndex[i]] = i;
+    }
+    std::vector<Eigen::Triplet<Scalar>> triplets;
+    for (int jj = 0; jj < stiffnessMatrix.outerSize(); jj++)
+    {
+        const int j = superToSubIndex[jj];
+        if (j < 0)
+        {
+            continue;
+        }
+        for (typename Eigen::SparseMatrix<Scalar>::InnerIterator it(stiffnessMatrix, jj); it; ++it)
+        {
+            const int i = superToSubIndex[it.row()];
+            if (i >= 0)
+            {
+                triplets.emplace_back(i, j, it.value());
+            }
+        }
+    }
+    Eigen::SparseMatrix<Scalar> res(numOfBasisFunctions, numOfBasisFunctions);
+    res.setFromTriplets(triplets.begin(), triplets.end());
+    return res;
+}
+
+template<typename Scalar_>
+StiffnessOperator<Scalar_>::StiffnessOperator(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, bool pinFirstBasisFunction)
+    : m_ctx(ctx)
+    , m_numOfPinnedBasisFunctions(pinFirstBasisFunction ? 1 : 0)
+{
+    const Mesh& mesh = *ctx.mesh;
+    StiffnessMatrixAssembler<Scalar> assembler(ctx, shapeFunctionFactory);
+    m_numOfBasisFunctions = assembler.basisFunctionIndexer.getNumOfBasisFunctions();
+    if (mesh.containsQuadrilateral())
+    {
+        m_quadKernel.emplace(ctx.p, ctx.polynomialSpaceType, shapeFunctionFactory);
+    }
+    if (mesh.containsTriangle())
+    {
+        assembler.precomputeIntegrals(ElementType_Triangle);
+        const auto& cache = assembler.integralCache[ElementType_Triangle];
+        const uint32_t numOfShapeFunctions = assembler.shapeFunctionIndexer.getNumOfShapeFunctions(ElementType_Triangle);
+        auto& xx = m_referenceIntegralsXx;
+        auto& xy = m_referenceIntegralsXy;
+        auto& yy = m_referenceIntegralsYy;
+        xx.resize(numOfShapeFunctions, numOfShapeFunctions);
+        xy.resize(numOfShapeFunctions, numOfShapeFunctions);
+        yy.resize(numOfShapeFunctions, numOfShapeFunctions);
+        size_t cacheIdx = 0;
+        for (int i = 0; i < numOfShapeFunctions; i++)
+        {
+            for (int j = i; j < numOfShapeFunctions; j++, cacheIdx++)
+            {
+                const auto& integrals = cache[cacheIdx];
+                xx(i,j) = xx(j,i) = integrals.xx;
+                xy(i,j) = xy(j,i) = integrals.xy + integrals.yx;
+                yy(i,j) = yy(j,i) = integrals.yy;
+            }
+        }
+    }
+
+    m_elementMetrics.resize(mesh.getNumOfElements());
+    m_elementBasisFunctionIndices.resize(mesh.getNumOfElements());
+    m_elementSigns.resize(mesh.getNumOfElements());
+    #pragma omp parallel for schedule(dynamic)
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        const ElementGeometry& geometry = mesh.getElementGeometry(elementIdx);
+        m_elementMetrics[elementIdx] = Matrix2mpq(geometry.detA * geometry.M).unaryExpr([](const mpq_class& x) { return convertRational<Scalar>(x); });
+        const ElementType elementType = mesh.getElement(elementIdx).getElementType();
+        const uint32_t numOfShapeFunctions = assembler.shapeFunctionIndexer.getNumOfShapeFunctions(elementType);
+        auto& basisFnIdxs = m_elementBasisFunctionIndices[elementIdx];
+        auto& signs = m_elementSigns[elementIdx];
+        basisFnIdxs.resize(numOfShapeFunctions);
+        signs = Eigen::VectorX<Scalar>::Ones(numOfShapeFunctions);
+        for (int shapeFnIdx = 0; shapeFnIdx < numOfShapeFunctions; shapeFnIdx++)
         {
-            const BasisFunctionDescriptor desc_j = subBasisFunctionIndexer.getBasisFunctionDescriptor(j);
-            const int jj = superBasisFunctionIndexer.getBasisFunctionIndex(desc_j);
-            res(i,j) = stiffnessMatrix(ii,jj);
+            basisFnIdxs[shapeFnIdx] = assembler.basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFnIdx);
+            const auto desc = assembler.shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx);
+            if (const auto* descp = std::get_if<SideShapeFunctionDescriptor>(&desc))
+            {
+                const auto adjacentElementIdx = mesh.getIndexOfAdjacentElement(elementIdx, descp->sideIdx);
+                if (adjacentElementIdx.has_value() && elementIdx < adjacentElementIdx.value() && descp->k % 2 != 0)
+                {
+                    signs(shapeFnIdx) = -1;
+                }
+            }
         }
     }
+}
+
+template<typename Scalar_>
+Eigen::VectorX<Scalar_> StiffnessOperator<Scalar_>::apply(const Eigen::VectorX<Scalar>& x) const
+{
+    assert(x.size() == cols());
+    Eigen::VectorX<Scalar> xFull(m_numOfBasisFunctions);
+    xFull.head(m_numOfPinnedBasisFunctions).setZero();
+    xFull.tail(x.size()) = x;
+    Eigen::VectorX<Scalar> yFull = Eigen::VectorX<Scalar>::Zero(m_numOfBasisFunctions);
+    const Mesh& mesh = *m_ctx.mesh;
+    /* Elements of the same color share no basis functions */
+    for (const auto& elementIdxs : mesh.getElementColors())
+    {
+        #pragma omp parallel for schedule(dynamic)
+        for (int k = 0; k < elementIdxs.size(); k++)
+        {
+            const Mesh::ElementIndex elementIdx = elementIdxs[k];
+            const ElementType elementType = mesh.getElement(elementIdx).getElementType();
+            const auto& basisFnIdxs = m_elementBasisFunctionIndices[elementIdx];
+            const Eigen::VectorX<Scalar>& signs = m_elementSigns[elementIdx];
+            const Eigen::Matrix2<Scalar>& G = m_elementMetrics[elementIdx];
+            const Eigen::VectorX<Scalar> xLocal = xFull(basisFnIdxs).cwiseProduct(signs);
+            Eigen::VectorX<Scalar> yLocal;
+            if (elementType == ElementType_Parallelogram)
+            {
+                yLocal = m_quadKernel->apply(G, xLocal);
+            }
+            else
+            {
+                yLocal = G(0,0) * (m_referenceIntegralsXx * xLocal);
+                yLocal += G(0,1) * (m_referenceIntegralsXy * xLocal);
+                yLocal += G(1,1) * (m_referenceIntegralsYy * xLocal);
+            }
+            yFull(basisFnIdxs) += yLocal.cwiseProduct(signs);
+        }
+    }
+    return yFull.tail(rows());
+}
+
+template<typename Scalar_>
+Eigen::MatrixX<Scalar_> StiffnessOperator<Scalar_>::getElementMatrix(Mesh::ElementIndex elementIdx) const
+{
+    const ElementType elementType = m_ctx.mesh->getElement(elementIdx).getElementType();
+    const Eigen::Matrix2<Scalar>& G = m_elementMetrics[elementIdx];
+    if (elementType == ElementType_Parallelogram)
+    {
+        return m_quadKernel->getElementMatrix(G);
+    }
+    Eigen::MatrixX<Scalar> res = G(0,0) * m_referenceIntegralsXx;
+    res += G(0,1) * m_referenceIntegralsXy;
+    res += G(1,1) * m_referenceIntegralsYy;
     return res;
 }
+
+template<typename Scalar_>
+std::vector<Eigen::MatrixX<Scalar_>> StiffnessOperator<Scalar_>::getDiagonalBlocks(const std::vector<std::vector<uint32_t>>& blocks) const
+{
+    std::vector<int> blockOf(m_numOfBasisFunctions, -1);
+    std::vector<uint32_t> positionInBlock(m_numOfBasisFunctions);
+    std::vector<Eigen::MatrixX<Scalar>> res(blocks.size());
+    for (int blockIdx = 0; blockIdx < blocks.size(); blockIdx++)
+    {
+        res[blockIdx] = Eigen::MatrixX<Scalar>::Zero(blocks[blockIdx].size(), blocks[blockIdx].size());
+        for (int i = 0; i < blocks[blockIdx].size(); i++)
+        {
+            const uint32_t basisFnIdx = blocks[blockIdx][i] + m_numOfPinnedBasisFunctions;
+            assert(basisFnIdx < m_numOfBasisFunctions && blockOf[basisFnIdx] < 0);
+            blockOf[basisFnIdx] = blockIdx;
+            positionInBlock[basisFnIdx] = i;
+        }
+    }
+    for (int elementIdx = 0; elementIdx < m_ctx.mesh->getNumOfElements(); elementIdx++)
+    {
+        const auto& basisFnIdxs = m_elementBasisFunctionIndices[elementIdx];
+        const Eigen::VectorX<Scalar>& signs = m_elementSigns[elementIdx];
+        const Eigen::MatrixX<Scalar> elementMatrix = getElementMatrix(elementIdx);
+        for (int j = 0; j < basisFnIdxs.size(); j++)
+        {
+            const int blockIdx = blockOf[basisFnIdxs[j]];
+            if (blockIdx < 0)
+            {
+                continue;
+            }
+            for (int i = 0; i < basisFnIdxs.size(); i++)
+            {
+                if (blockOf[basisFnIdxs[i]] == blockIdx)
+                {
+                    res[blockIdx](positionInBlock[basisFnIdxs[i]], positionInBlock[basisFnIdxs[j]]) += signs(i) * signs(j) * elementMatrix(i,j);
+                }
+            }
+        }
+    }
+    return res;
+}
+
+#define INSTANTIATE_STIFFNESS_MATRIX_FUNCTIONS(Scalar) \
+    template Eigen::MatrixX<Scalar> assembleStiffnessMatrix<Scalar>(const FemContext&, const ShapeFunctionFactory&); \
+    template Eigen::MatrixX<Scalar> extractSubStiffnessMatrix<Scalar>(const FemContext&, const Eigen::MatrixX<Scalar>&, uint32_t); \
+    template Eigen::SparseMatrix<Scalar> assembleSparseStiffnessMatrix<Scalar>(const FemContext&, const ShapeFunctionFactory&); \
+    template Eigen::SparseMatrix<Scalar> extractSubStiffnessMatrix<Scalar>(const FemContext&, const Eigen::SparseMatrix<Scalar>&, uint32_t); \
+    template Eigen::MatrixX<Scalar> enrichStiffnessMatrix<Scalar>(const FemContext&, const Eigen::MatrixX<Scalar>&, const ShapeFunctionFactory&); \
+    template Eigen::SparseMatrix<Scalar> enrichStiffnessMatrix<Scalar>(const FemContext&, const Eigen::SparseMatrix<Scalar>&, const ShapeFunctionFactory&);
+
+INSTANTIATE_STIFFNESS_MATRIX_FUNCTIONS(mpq_class)
+INSTANTIATE_STIFFNESS_MATRIX_FUNCTIONS(mpf_class)
+INSTANTIATE_STIFFNESS_MATRIX_FUNCTIONS(double)
+INSTANTIATE_STIFFNESS_MATRIX_FUNCTIONS(long double)
+
+template class StiffnessOperator<mpf_class>;
+template class StiffnessOperator<double>;
+template class StiffnessOperator<long double>;
 } // namespace fem
@@ -1,16 +1,151 @@
 #pragma once
 
 #include <cstdint>
+#include <optional>
+#include <vector>
 
+#include "fem/assembly/QuadStiffnessKernel.hpp"
 #include "fem/basis/FemContext.hpp"
 #include "fem/basis/ShapeFunctionFactory.hpp"
+#include "fem/multiprecision/ModularArithmetic.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
-MatrixXmpq assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory);
-MatrixXmpq extractSubStiffnessMatrix(const FemContext& ctx, const MatrixXmpq& stiffnessMatrix, uint32_t p);
+/* Scalar is one of mpq_class (exact), mpf_class, double or long double. The reference integrals are always
+ * computed exactly, only the element scaling and the global scatter are done in Scalar. */
+template<typename Scalar = mpq_class>
+Eigen::MatrixX<Scalar> assembleStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory);
+template<typename Scalar>
+Eigen::MatrixX<Scalar> extractSubStiffnessMatrix(const FemContext& ctx, const Eigen::MatrixX<Scalar>& stiffnessMatrix, uint32_t p);
+
+/* Only the couplings between basis functions sharing an element are stored */
+template<typename Scalar = mpq_class>
+Eigen::SparseMatrix<Scalar> assembleSparseStiffnessMatrix(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory);
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> extractSubStiffnessMatrix(const FemContext& ctx, const Eigen::SparseMatrix<Scalar>& stiffnessMatrix, uint32_t p);
+
+/*
+ * Stiffness matrix of degree ctx.p from the one of degree ctx.p - 1. The basis is hierarchical, so only the entries
+ * involving the shape functions added at degree ctx.p are integrated and the rest are copied over.
+ */
+template<typename Scalar>
+Eigen::MatrixX<Scalar> enrichStiffnessMatrix(const FemContext& ctx, const Eigen::MatrixX<Scalar>& stiffnessMatrix, const ShapeFunctionFactory& shapeFunctionFactory);
+template<typename Scalar>
+Eigen::SparseMatrix<Scalar> enrichStiffnessMatrix(const FemContext& ctx, const Eigen::SparseMatrix<Scalar>& stiffnessMatrix, const ShapeFunctionFactory& shapeFunctionFactory);
+
+/*
+ * Stiffness matrix modulo 62-bit primes, for solveMultiModular. The exact element blocks of the distinct element
+ * shapes and the scatter pattern are computed once, after which each prime only needs the blocks reduced and a
+ * scatter with uint64_t additions.
+ */
+class ModularStiffnessMatrixAssembler
+{
+public:
+    ModularStiffnessMatrixAssembler(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory);
+
+    /* Nothing if prime divides a denominator of the matrix. Can be called concurrently. */
+    std::optional<ModularSparseMatrix> assemble(uint64_t prime) const;
+
+private:
+    struct Entry
+    {
+        uint32_t row;
+        uint32_t col;
+        size_t blockIdx;
+        bool isNegated;
+    };
+
+    uint32_t m_numOfBasisFunctions;
+    /* The element blocks of all similarity classes one after another */
+    std::vector<mpq_class> m_blockEntries;
+    /* Both triangles of the matrix, duplicates being summed */
+    std::vector<Entry> m_entries;
+};
 
 /* Slow reference implementation */
 MatrixXmpq assembleStiffnessMatrix(const FemContext& ctx);
+
+template<typename Scalar_>
+class StiffnessOperator;
 } // namespace fem
+
+namespace Eigen::internal
+{
+template<typename Scalar_>
+struct traits<fem::StiffnessOperator<Scalar_>> : public traits<Eigen::SparseMatrix<Scalar_>>
+{
+};
+} // namespace Eigen::internal
+
+namespace fem
+{
+/*
+ * Matrix-free stiffness matrix: y = K*x is computed element by element from the reference integrals of the shape
+ * function gradients and the element metrics det(A) A^-1 A^-T, so the memory use is linear in the number of basis
+ * functions. The quads are applied with the sum-factorized QuadStiffnessKernel. Works as a matrix replacement with
+ * Eigen's iterative solvers.
+ * With pinFirstBasisFunction the first basis function is left out, i.e. its coefficient is fixed to zero.
+ * Scalar_ is one of mpf_class, double or long double.
+ */
+template<typename Scalar_>
+class StiffnessOperator : public Eigen::EigenBase<StiffnessOperator<Scalar_>>
+{
+public:
+    using Scalar = Scalar_;
+    using RealScalar = Scalar_;
+    using StorageIndex = int;
+    enum
+    {
+        ColsAtCompileTime = Eigen::Dynamic,
+        MaxColsAtCompileTime = Eigen::Dynamic,
+        IsRowMajor = false
+    };
+
+    StiffnessOperator(const FemContext& ctx, const ShapeFunctionFactory& shapeFunctionFactory, bool pinFirstBasisFunction = false);
+
+    Eigen::Index rows() const { return m_numOfBasisFunctions - m_numOfPinnedBasisFunctions; }
+    Eigen::Index cols() const { return rows(); }
+
+    template<typename Rhs>
+    Eigen::Product<StiffnessOperator, Rhs, Eigen::AliasFreeProduct> operator*(const Eigen::MatrixBase<Rhs>& x) const
+    {
+        return Eigen::Product<StiffnessOperator, Rhs, Eigen::AliasFreeProduct>(*this, x.derived());
+    }
+
+    Eigen::VectorX<Scalar> apply(const Eigen::VectorX<Scalar>& x) const;
+    /* Diagonal blocks of the matrix on the given groups of unknowns */
+    std::vector<Eigen::MatrixX<Scalar>> getDiagonalBlocks(const std::vector<std::vector<uint32_t>>& blocks) const;
+
+private:
+    /* Without the side orientation signs */
+    Eigen::MatrixX<Scalar> getElementMatrix(Mesh::ElementIndex elementIdx) const;
+
+private:
+    FemContext m_ctx;
+    uint32_t m_numOfBasisFunctions;
+    uint32_t m_numOfPinnedBasisFunctions;
+    /* Reference integrals of (dx, dx), (dx, dy) + (dy, dx) and (dy, dy) over the reference triangle */
+    Eigen::MatrixX<Scalar> m_referenceIntegralsXx;
+    Eigen::MatrixX<Scalar> m_referenceIntegralsXy;
+    Eigen::MatrixX<Scalar> m_referenceIntegralsYy;
+    std::optional<QuadStiffnessKernel<Scalar>> m_quadKernel;
+    std::vector<Eigen::Matrix2<Scalar>> m_elementMetrics;
+    std::vector<std::vector<uint32_t>> m_elementBasisFunctionIndices;
+    std::vector<Eigen::VectorX<Scalar>> m_elementSigns;
+};
+} // namespace fem
+
+namespace Eigen::internal
+{
+template<typename Scalar_, typename Rhs>
+struct generic_product_impl<fem::StiffnessOperator<Scalar_>, Rhs, SparseShape, DenseShape, GemvProduct>
+    : generic_product_impl_base<fem::StiffnessOperator<Scalar_>, Rhs, generic_product_impl<fem::StiffnessOperator<Scalar_>, Rhs>>
+{
+    template<typename Dest>
+    static void scaleAndAddTo(Dest& dst, const fem::StiffnessOperator<Scalar_>& lhs, const Rhs& rhs, const Scalar_& alpha)
+    {
+        dst.noalias() += alpha * lhs.apply(rhs);
+    }
+};
+} // namespace Eigen::internal
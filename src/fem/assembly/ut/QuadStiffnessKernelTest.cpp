@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include "fem/assembly/QuadStiffnessKernel.hpp"
+#include "fem/basis/ShapeFunctionIndexer.hpp"
+#include "fem/math/Polynomial.hpp"
+
+namespace fem::ut
+{
+TEST(QuadStiffnessKernelTest, ReferenceIntegralsMatch2DIntegrals)
+{
+    const uint32_t p = 5;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p);
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const ShapeFunctionIndexer shapeFunctionIndexer(p, polynomialSpaceType);
+        const QuadStiffnessKernel<mpq_class> kernel(p, polynomialSpaceType, shapeFunctionFactory);
+        ASSERT_EQ(kernel.getNumOfShapeFunctions(), shapeFunctionIndexer.getNumOfShapeFunctions(ElementType_Parallelogram));
+        for (uint32_t i = 0; i < kernel.getNumOfShapeFunctions(); i++)
+        {
+            const auto desc1 = shapeFunctionIndexer.getShapeFunctionDescriptor(ElementType_Parallelogram, i);
+            const Polynomial2D& fn1Dx = shapeFunctionFactory.getShapeFunctionDerivative(ElementType_Parallelogram, desc1, 'x');
+            const Polynomial2D& fn1Dy = shapeFunctionFactory.getShapeFunctionDerivative(ElementType_Parallelogram, desc1, 'y');
+            for (uint32_t j = 0; j < kernel.getNumOfShapeFunctions(); j++)
+            {
+                const auto desc2 = shapeFunctionIndexer.getShapeFunctionDescriptor(ElementType_Parallelogram, j);
+                const Polynomial2D& fn2Dx = shapeFunctionFactory.getShapeFunctionDerivative(ElementType_Parallelogram, desc2, 'x');
+                const Polynomial2D& fn2Dy = shapeFunctionFactory.getShapeFunctionDerivative(ElementType_Parallelogram, desc2, 'y');
+                const auto integrals = kernel.getReferenceIntegrals(i, j);
+                EXPECT_EQ(integrals.xx, integrateProductOverReferenceElement(fn1Dx, fn2Dx, ElementType_Parallelogram));
+                EXPECT_EQ(integrals.xy, integrateProductOverReferenceElement(fn1Dx, fn2Dy, ElementType_Parallelogram));
+                EXPECT_EQ(integrals.yx, integrateProductOverReferenceElement(fn1Dy, fn2Dx, ElementType_Parallelogram));
+                EXPECT_EQ(integrals.yy, integrateProductOverReferenceElement(fn1Dy, fn2Dy, ElementType_Parallelogram));
+            }
+        }
+    }
+}
+
+TEST(QuadStiffnessKernelTest, ApplyMatchesElementMatrix)
+{
+    const uint32_t p = 4;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p + 1);
+    Matrix2mpq G;
+    G << mpq_class(3, 2), mpq_class(-1, 3),
+         mpq_class(-1, 3), mpq_class(5, 7);
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const QuadStiffnessKernel<mpq_class> kernel(p, polynomialSpaceType, shapeFunctionFactory);
+        const uint32_t n = kernel.getNumOfShapeFunctions();
+        VectorXmpq x(n);
+        for (uint32_t i = 0; i < n; i++)
+        {
+            x(i) = mpq_class(static_cast<int>(i % 5) - 2) / (i + 1);
+        }
+        const MatrixXmpq elementMatrix = kernel.getElementMatrix(G);
+        EXPECT_EQ(elementMatrix, elementMatrix.transpose());
+        EXPECT_EQ(kernel.apply(G, x), elementMatrix * x);
+
+        const QuadStiffnessKernel<double> kernelDouble(p, polynomialSpaceType, shapeFunctionFactory);
+        const Eigen::Matrix2d Gd = G.unaryExpr([](const mpq_class& v) { return v.get_d(); });
+        const Eigen::VectorXd xd = x.unaryExpr([](const mpq_class& v) { return v.get_d(); });
+        const Eigen::VectorXd yd = (elementMatrix * x).unaryExpr([](const mpq_class& v) { return v.get_d(); });
+        EXPECT_TRUE(kernelDouble.apply(Gd, xd).isApprox(yd, 1e-13));
+    }
+}
+} // namespace fem::ut
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include "fem/assembly/LoadVector.hpp"
+#include "fem/assembly/StaticCondensation.hpp"
+#include "fem/assembly/StiffnessMatrix.hpp"
+
+namespace fem::ut
+{
+namespace
+{
+/* Solution with the first nodal value pinned to zero */
+template<typename MatrixType>
+Eigen::VectorX<typename MatrixType::Scalar> solvePinned(const MatrixType& A, const Eigen::VectorX<typename MatrixType::Scalar>& b)
+{
+    using Scalar = typename MatrixType::Scalar;
+    const uint32_t dim = b.size();
+    const Eigen::MatrixX<Scalar> A_r = Eigen::MatrixX<Scalar>(A).bottomRightCorner(dim-1, dim-1);
+    Eigen::VectorX<Scalar> x(dim);
+    x(0) = 0;
+    x.segment(1, dim-1) = A_r.partialPivLu().solve(b.segment(1, dim-1));
+    return x;
+}
+} // namespace
+
+TEST(StaticCondensationTest, CondensedSolutionMatchesFullSolution)
+{
+    const auto mesh = std::make_shared<Mesh>(createStructuredMesh(StructuredMeshType_Mixed, 2, 2, Vector2mpq{-1, -1}, Vector2mpq{1, 1}));
+    const Vector2mpq x_0{mpq_class(1, 3), mpq_class(1, 5)};
+    const uint32_t p_max = 4;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p_max);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p_max);
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        for (const BasisFunctionOrdering basisFunctionOrdering : {BasisFunctionOrdering_Standard, BasisFunctionOrdering_Hierarchical})
+        {
+            for (uint32_t p = 1; p <= p_max; p++)
+            {
+                const FemContext ctx(mesh, p, polynomialSpaceType, basisFunctionOrdering);
+                const MatrixXmpq A = assembleStiffnessMatrix<mpq_class>(ctx, shapeFunctionFactory);
+                const VectorXmpq b = assembleDiracLoadVector(ctx, x_0, shapeFunctionFactory);
+                const VectorXmpq x = solvePinned(A, b);
+
+                const StaticCondensation<MatrixXmpq> staticCondensation(ctx, A);
+                const MatrixXmpq& S = staticCondensation.getCondensedStiffnessMatrix();
+                const uint32_t numOfCondensedBasisFunctions = mesh->getNumOfNodes() + mesh->getNumOfSides() * (p-1);
+                ASSERT_EQ(S.rows(), numOfCondensedBasisFunctions);
+                EXPECT_EQ(MatrixXmpq(S.transpose()), S);
+                const VectorXmpq condensedSolution = solvePinned(S, staticCondensation.condenseLoadVector(b));
+                EXPECT_EQ(staticCondensation.expandSolution(condensedSolution, b), x);
+
+                const SparseMatrixXmpq sparseA = assembleSparseStiffnessMatrix<mpq_class>(ctx, shapeFunctionFactory);
+                const StaticCondensation<SparseMatrixXmpq> sparseStaticCondensation(ctx, sparseA);
+                EXPECT_EQ(MatrixXmpq(sparseStaticCondensation.getCondensedStiffnessMatrix()), S);
+                EXPECT_EQ(sparseStaticCondensation.condenseLoadVector(b), staticCondensation.condenseLoadVector(b));
+                EXPECT_EQ(sparseStaticCondensation.expandSolution(condensedSolution, b), x);
+            }
+        }
+    }
+}
+
+TEST(StaticCondensationTest, DoubleStaticCondensation)
+{
+    const auto mesh = std::make_shared<Mesh>(createStructuredMesh(StructuredMeshType_Triangle, 2, 2, Vector2mpq{-1, -1}, Vector2mpq{1, 1}));
+    const uint32_t p = 5;
+    const FemContext ctx(mesh, p, PolynomialSpaceType_Trunk);
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p);
+    const VectorXmpq b = assembleDiracLoadVector(ctx, Vector2mpq{mpq_class(1, 3), mpq_class(1, 5)}, shapeFunctionFactory);
+    const Eigen::VectorXd b_d = b.unaryExpr([](const mpq_class& x) { return x.get_d(); });
+    const Eigen::VectorXd x = solvePinned(assembleStiffnessMatrix<double>(ctx, shapeFunctionFactory), b_d);
+
+    const StaticCondensation<Eigen::SparseMatrix<double>> staticCondensation(ctx, assembleSparseStiffnessMatrix<double>(ctx, shapeFunctionFactory));
+    const Eigen::VectorXd condensedSolution = solvePinned(staticCondensation.getCondensedStiffnessMatrix(), staticCondensation.condenseLoadVector(b_d));
+    EXPECT_TRUE(staticCondensation.expandSolution(condensedSolution, b_d).isApprox(x, 1e-12));
+}
+} // namespace fem::ut
@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include "fem/assembly/StiffnessMatrix.hpp"
+#include "fem/basis/BasisFunctionIndexer.hpp"
+#include "fem/multiprecision/FractionFreeSolver.hpp"
+#include "fem/multiprecision/MultiModularSolver.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 #include "fem/assembly/ut/refdata/stiffness_matrix1/RefStiffnessMatrix1.hpp"
 #include "fem/assembly/ut/refdata/stiffness_matrix2/RefStiffnessMatrix2.hpp"
 #include "fem/assembly/ut/refdata/stiffness_matrix3/RefStiffnessMatrix3.hpp"
@@ -46,6 +50,44 @@ TEST(StiffnessMatrixTest, StiffnessMatrix3)
     EXPECT_EQ(assembleStiffnessMatrix(ctx, shapeFunctionFactory), refdata::refStiffnessMatrix3);
 }
 
+TEST(StiffnessMatrixTest, StructuredMeshStiffnessMatrix)
+{
+    /* Most elements fall into a few similarity classes, and elements of the same class have different sign flips */
+    const uint32_t p = 3;
+    const auto mesh = std::make_shared<Mesh>(createStructuredMesh(StructuredMeshType_Mixed, 3, 2, Vector2mpq(-1, 0), Vector2mpq(1, mpq_class("1/3"))));
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Trunk, PolynomialSpaceType_Product})
+    {
+        const FemContext ctx(mesh, p, polynomialSpaceType);
+        ShapeFunctionFactory shapeFunctionFactory;
+        shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p);
+        shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p);
+        EXPECT_EQ(assembleStiffnessMatrix(ctx, shapeFunctionFactory), assembleStiffnessMatrix(ctx));
+    }
+}
+
+TEST(StiffnessMatrixTest, EnrichStiffnessMatrix)
+{
+    const uint32_t p_max = 4;
+    const auto mesh = std::make_shared<Mesh>(createStructuredMesh(StructuredMeshType_Mixed, 2, 2, Vector2mpq(-1, -1), Vector2mpq(1, 1)));
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p_max);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p_max);
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Trunk, PolynomialSpaceType_Product})
+    {
+        MatrixXmpq stiffnessMatrix = assembleStiffnessMatrix(FemContext(mesh, 1, polynomialSpaceType), shapeFunctionFactory);
+        SparseMatrixXmpq sparseStiffnessMatrix = assembleSparseStiffnessMatrix(FemContext(mesh, 1, polynomialSpaceType), shapeFunctionFactory);
+        for (uint32_t p = 2; p <= p_max; p++)
+        {
+            const FemContext ctx(mesh, p, polynomialSpaceType);
+            stiffnessMatrix = enrichStiffnessMatrix(ctx, stiffnessMatrix, shapeFunctionFactory);
+            sparseStiffnessMatrix = enrichStiffnessMatrix(ctx, sparseStiffnessMatrix, shapeFunctionFactory);
+            const MatrixXmpq expected = assembleStiffnessMatrix(ctx, shapeFunctionFactory);
+            EXPECT_EQ(stiffnessMatrix, expected);
+            EXPECT_EQ(MatrixXmpq(sparseStiffnessMatrix), expected);
+        }
+    }
+}
+
 TEST(StiffnessMatrixTest, ExtractSubStiffnessMatrix)
 {
     const std::vector<Node> nodes = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}, {0, 2}};
@@ -64,4 +106,189 @@ TEST(StiffnessMatrixTest, ExtractSubStiffnessMatrix)
         }
     }
 }
+
+TEST(StiffnessMatrixTest, HierarchicalOrdering)
+{
+    const std::vector<Node> nodes = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}, {0, 2}};
+    const std::vector<std::vector<Mesh::ElementIndex>> elements = {{0, 1, 2, 3}, {3, 2, 4}};
+    const auto mesh = std::make_shared<Mesh>(nodes, elements);
+    const uint32_t p_max = 4;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p_max);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p_max);
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const FemContext ctx(mesh, p_max, polynomialSpaceType, BasisFunctionOrdering_Hierarchical);
+        const MatrixXmpq stiffnessMatrix = assembleStiffnessMatrix<mpq_class>(ctx, shapeFunctionFactory);
+        const SparseMatrixXmpq sparseStiffnessMatrix = assembleSparseStiffnessMatrix<mpq_class>(ctx, shapeFunctionFactory);
+        EXPECT_EQ(MatrixXmpq(sparseStiffnessMatrix), stiffnessMatrix);
+
+        const FemContext standardCtx(mesh, p_max, polynomialSpaceType);
+        const MatrixXmpq standardStiffnessMatrix = assembleStiffnessMatrix<mpq_class>(standardCtx, shapeFunctionFactory);
+        const BasisFunctionIndexer indexer(ctx);
+        const BasisFunctionIndexer standardIndexer(standardCtx);
+        std::vector<uint32_t> hierarchicalToStandard(indexer.getNumOfBasisFunctions());
+        for (uint32_t i = 0; i < hierarchicalToStandard.size(); i++)
+        {
+            hierarchicalToStandard[i] = standardIndexer.getBasisFunctionIndex(indexer.getBasisFunctionDescriptor(i));
+        }
+        EXPECT_EQ(MatrixXmpq(standardStiffnessMatrix(hierarchicalToStandard, hierarchicalToStandard)), stiffnessMatrix);
+
+        for (uint32_t p = 1; p <= p_max; p++)
+        {
+            const FemContext subCtx(mesh, p, polynomialSpaceType, BasisFunctionOrdering_Hierarchical);
+            const MatrixXmpq subStiffnessMatrix = assembleStiffnessMatrix<mpq_class>(subCtx, shapeFunctionFactory);
+            const uint32_t n = subStiffnessMatrix.rows();
+            EXPECT_EQ(MatrixXmpq(stiffnessMatrix.topLeftCorner(n, n)), subStiffnessMatrix);
+            EXPECT_EQ(extractSubStiffnessMatrix(ctx, stiffnessMatrix, p), subStiffnessMatrix);
+            EXPECT_EQ(MatrixXmpq(extractSubStiffnessMatrix(ctx, sparseStiffnessMatrix, p)), subStiffnessMatrix);
+            if (p > 1)
+            {
+                const FemContext previousCtx(mesh, p-1, polynomialSpaceType, BasisFunctionOrdering_Hierarchical);
+                const MatrixXmpq previousStiffnessMatrix = assembleStiffnessMatrix<mpq_class>(previousCtx, shapeFunctionFactory);
+                EXPECT_EQ(enrichStiffnessMatrix(subCtx, previousStiffnessMatrix, shapeFunctionFactory), subStiffnessMatrix);
+            }
+        }
+    }
+}
+
+TEST(StiffnessMatrixTest, SparseStiffnessMatrix)
+{
+    const std::string meshFilenames[2] = {
+        std::string{SRC_DIR} + std::string{"/refdata/stiffness_matrix1/mesh.txt"},
+        std::string{SRC_DIR} + std::string{"/refdata/stiffness_matrix2/mesh.txt"}
+    };
+    const PolynomialSpaceType polynomialSpaceTypes[2] = {PolynomialSpaceType_Trunk, PolynomialSpaceType_Product};
+    const MatrixXmpq* refStiffnessMatrices[2] = {&refdata::refStiffnessMatrix1, &refdata::refStiffnessMatrix2};
+    const uint32_t p = 4;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p);
+    for (int i = 0; i < 2; i++)
+    {
+        const FemContext ctx(std::make_shared<Mesh>(createMeshFromFile(meshFilenames[i])), p, polynomialSpaceTypes[i]);
+        const SparseMatrixXmpq stiffnessMatrix = assembleSparseStiffnessMatrix(ctx, shapeFunctionFactory);
+        EXPECT_EQ(MatrixXmpq(stiffnessMatrix), *refStiffnessMatrices[i]);
+        for (int subP = 1; subP <= p; subP++)
+        {
+            const MatrixXmpq subStiffnessMatrix = extractSubStiffnessMatrix(ctx, *refStiffnessMatrices[i], subP);
+            EXPECT_EQ(MatrixXmpq(extractSubStiffnessMatrix(ctx, stiffnessMatrix, subP)), subStiffnessMatrix);
+        }
+    }
+}
+
+TEST(StiffnessMatrixTest, DoubleStiffnessMatrix)
+{
+    const std::string meshFilename = std::string{SRC_DIR} + std::string{"/refdata/stiffness_matrix2/mesh.txt"};
+    const uint32_t p = 4;
+    const FemContext ctx(std::make_shared<Mesh>(createMeshFromFile(meshFilename)), p, PolynomialSpaceType_Product);
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p);
+    const Eigen::MatrixXd refStiffnessMatrix = refdata::refStiffnessMatrix2.unaryExpr([](const mpq_class& x) { return x.get_d(); });
+    const Eigen::MatrixXd stiffnessMatrix = assembleStiffnessMatrix<double>(ctx, shapeFunctionFactory);
+    EXPECT_TRUE(stiffnessMatrix.isApprox(refStiffnessMatrix, 1e-14));
+    const Eigen::SparseMatrix<double> sparseStiffnessMatrix = assembleSparseStiffnessMatrix<double>(ctx, shapeFunctionFactory);
+    EXPECT_TRUE(Eigen::MatrixXd(sparseStiffnessMatrix).isApprox(refStiffnessMatrix, 1e-14));
+    for (int subP = 1; subP <= p; subP++)
+    {
+        const Eigen::MatrixXd subStiffnessMatrix = extractSubStiffnessMatrix(ctx, stiffnessMatrix, subP);
+        EXPECT_EQ(Eigen::MatrixXd(extractSubStiffnessMatrix(ctx, sparseStiffnessMatrix, subP)), subStiffnessMatrix);
+    }
+
+    const Eigen::MatrixX<long double> refStiffnessMatrixLd = refdata::refStiffnessMatrix2.unaryExpr([](const mpq_class& x) { return convertRational<long double>(x); });
+    EXPECT_TRUE(assembleStiffnessMatrix<long double>(ctx, shapeFunctionFactory).isApprox(refStiffnessMatrixLd, 1e-17L));
+}
+
+TEST(StiffnessMatrixTest, ModularStiffnessMatrix)
+{
+    const std::string meshFilenames[2] = {
+        std::string{SRC_DIR} + std::string{"/refdata/stiffness_matrix1/mesh.txt"},
+        std::string{SRC_DIR} + std::string{"/refdata/stiffness_matrix2/mesh.txt"}
+    };
+    const PolynomialSpaceType polynomialSpaceTypes[2] = {PolynomialSpaceType_Trunk, PolynomialSpaceType_Product};
+    const MatrixXmpq* refStiffnessMatrices[2] = {&refdata::refStiffnessMatrix1, &refdata::refStiffnessMatrix2};
+    const uint32_t p = 4;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p);
+    for (int i = 0; i < 2; i++)
+    {
+        const FemContext ctx(std::make_shared<Mesh>(createMeshFromFile(meshFilenames[i])), p, polynomialSpaceTypes[i]);
+        const ModularStiffnessMatrixAssembler assembler(ctx, shapeFunctionFactory);
+        const SparseMatrixXmpq refStiffnessMatrix = refStiffnessMatrices[i]->sparseView();
+        ModularPrimeSequence primes;
+        for (int primeIdx = 0; primeIdx < 3; primeIdx++)
+        {
+            const uint64_t prime = primes.next();
+            const std::optional<ModularSparseMatrix> stiffnessMatrix = assembler.assemble(prime);
+            const std::optional<ModularSparseMatrix> expected = reduceRational(refStiffnessMatrix, prime);
+            ASSERT_TRUE(stiffnessMatrix.has_value() && expected.has_value());
+            EXPECT_EQ(Eigen::MatrixX<uint64_t>(*stiffnessMatrix), Eigen::MatrixX<uint64_t>(*expected));
+        }
+
+        /* The first basis function is pinned to make the system nonsingular */
+        const uint32_t dim = refStiffnessMatrix.rows();
+        const SparseMatrixXmpq reducedStiffnessMatrix = refStiffnessMatrix.bottomRightCorner(dim-1, dim-1);
+        VectorXmpq b(dim-1);
+        for (uint32_t k = 0; k < dim-1; k++)
+        {
+            b(k) = mpq_class(static_cast<int>(k % 7) - 3) / (k + 2);
+        }
+        const std::optional<VectorXmpq> solution = solveMultiModular([&assembler, dim](uint64_t prime) -> std::optional<ModularSparseMatrix>
+        {
+            const std::optional<ModularSparseMatrix> stiffnessMatrix = assembler.assemble(prime);
+            if (!stiffnessMatrix)
+            {
+                return std::nullopt;
+            }
+            return ModularSparseMatrix(stiffnessMatrix->bottomRightCorner(dim-1, dim-1));
+        }, b);
+        ASSERT_TRUE(solution);
+        EXPECT_EQ(solution, solveFractionFree(reducedStiffnessMatrix, b));
+    }
+}
+
+TEST(StiffnessMatrixTest, StiffnessOperator)
+{
+    const auto mesh = std::make_shared<Mesh>(createStructuredMesh(StructuredMeshType_Mixed, 3, 2, Vector2mpq{-1, -1}, Vector2mpq{2, 1}));
+    const uint32_t p = 4;
+    ShapeFunctionFactory shapeFunctionFactory;
+    shapeFunctionFactory.createShapeFunctions(ElementType_Parallelogram, p);
+    shapeFunctionFactory.createShapeFunctions(ElementType_Triangle, p);
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const FemContext ctx(mesh, p, polynomialSpaceType);
+        const Eigen::MatrixXd stiffnessMatrix = assembleStiffnessMatrix<double>(ctx, shapeFunctionFactory);
+        const uint32_t dim = stiffnessMatrix.rows();
+        const Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(dim, -1.0, 2.0);
+
+        const StiffnessOperator<double> stiffnessOperator(ctx, shapeFunctionFactory);
+        ASSERT_EQ(stiffnessOperator.rows(), dim);
+        EXPECT_TRUE(Eigen::VectorXd(stiffnessOperator * x).isApprox(stiffnessMatrix * x, 1e-13));
+
+        const StiffnessOperator<double> pinnedStiffnessOperator(ctx, shapeFunctionFactory, true);
+        const Eigen::MatrixXd reducedStiffnessMatrix = stiffnessMatrix.bottomRightCorner(dim-1, dim-1);
+        const Eigen::VectorXd x_r = x.tail(dim-1);
+        ASSERT_EQ(pinnedStiffnessOperator.rows(), dim-1);
+        EXPECT_TRUE(Eigen::VectorXd(pinnedStiffnessOperator * x_r).isApprox(reducedStiffnessMatrix * x_r, 1e-13));
+
+        const std::vector<std::vector<uint32_t>> blocks{{0, 1, 5}, {2}, {dim-3, dim-2}};
+        const std::vector<Eigen::MatrixXd> diagonalBlocks = pinnedStiffnessOperator.getDiagonalBlocks(blocks);
+        for (int blockIdx = 0; blockIdx < blocks.size(); blockIdx++)
+        {
+            const Eigen::MatrixXd refBlock = reducedStiffnessMatrix(blocks[blockIdx], blocks[blockIdx]);
+            EXPECT_TRUE(diagonalBlocks[blockIdx].isApprox(refBlock, 1e-13));
+        }
+
+        Eigen::ConjugateGradient<StiffnessOperator<double>, Eigen::Lower | Eigen::Upper, Eigen::IdentityPreconditioner> conjugateGradient;
+        conjugateGradient.setTolerance(1e-12);
+        conjugateGradient.setMaxIterations(100 * (dim-1));
+        conjugateGradient.compute(pinnedStiffnessOperator);
+        const Eigen::VectorXd b = reducedStiffnessMatrix * x_r;
+        const Eigen::VectorXd solution = conjugateGradient.solve(b);
+        EXPECT_EQ(conjugateGradient.info(), Eigen::Success);
+        EXPECT_LE((reducedStiffnessMatrix * solution - b).norm(), 1e-10 * b.norm());
+    }
+}
 } // namespace fem::ut
@@ -1,6 +1,8 @@
 #include "fem/basis/BasisFunctionIndexer.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <numeric>
 
 namespace fem
 {
@@ -20,12 +22,52 @@ BasisFunctionIndexer::BasisFunctionIndexer(const FemContext& ctx)
     : m_mesh(ctx.mesh)
     , m_p(ctx.p)
     , m_polynomialSpaceType(ctx.polynomialSpaceType)
+    , m_basisFunctionOrdering(ctx.basisFunctionOrdering)
     , m_numOfNodalBasisFunctions(m_mesh->getNumOfNodes())
     , m_numOfSideBasisFunctions(m_mesh->getNumOfSides() * (m_p-1))
     , m_accumulatedNumsOfInternalBasisFunctions(calculateAccumulatedNumsOfInternalBasisFunctions(*m_mesh, m_p, m_polynomialSpaceType))
     , m_numOfBasisFunctions(m_numOfNodalBasisFunctions + m_numOfSideBasisFunctions + m_accumulatedNumsOfInternalBasisFunctions.back())
     , m_shapeFunctionIndexer(ShapeFunctionIndexer(m_p, m_polynomialSpaceType))
 {
+    if (m_basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        initializeHierarchicalOrdering();
+    }
+}
+
+void BasisFunctionIndexer::initializeHierarchicalOrdering()
+{
+    /* Group the internal shape functions of each element type by degree, keeping their relative order */
+    for (ElementType elementType : {ElementType_Triangle, ElementType_Parallelogram})
+    {
+        auto& internalShapeFunctionsOfDegree = m_internalShapeFunctionsOfDegree[elementType];
+        auto& positionWithinDegree = m_internalShapeFunctionPositionWithinDegree[elementType];
+        internalShapeFunctionsOfDegree.resize(m_p+1);
+        for (int i = 0; i < m_shapeFunctionIndexer.getNumOfInternalShapeFunctions(elementType); i++)
+        {
+            const InternalShapeFunctionDescriptor desc = m_shapeFunctionIndexer.getInternalShapeFunctionDescriptor(elementType, i);
+            const uint32_t degree = m_shapeFunctionIndexer.getInternalShapeFunctionDegree(elementType, desc);
+            assert(degree >= 2 && degree <= m_p);
+            positionWithinDegree.push_back(internalShapeFunctionsOfDegree[degree].size());
+            internalShapeFunctionsOfDegree[degree].push_back(desc);
+        }
+    }
+
+    const uint32_t numOfSides = m_mesh->getNumOfSides();
+    m_accumulatedNumsOfInternalBasisFunctionsOfDegree.resize(m_p+1);
+    m_degreeOffsets = {0, 0, m_numOfNodalBasisFunctions};
+    for (int degree = 2; degree <= m_p; degree++)
+    {
+        auto& accumulatedNums = m_accumulatedNumsOfInternalBasisFunctionsOfDegree[degree];
+        accumulatedNums.push_back(0);
+        for (int elementIdx = 0; elementIdx < m_mesh->getNumOfElements(); elementIdx++)
+        {
+            const ElementType elementType = m_mesh->getElement(elementIdx).getElementType();
+            accumulatedNums.push_back(accumulatedNums.back() + m_internalShapeFunctionsOfDegree[elementType][degree].size());
+        }
+        m_degreeOffsets.push_back(m_degreeOffsets.back() + numOfSides + accumulatedNums.back());
+    }
+    assert(m_degreeOffsets.back() == m_numOfBasisFunctions);
 }
 
 uint32_t BasisFunctionIndexer::getNumOfElements() const
@@ -61,6 +103,10 @@ BasisFunctionDescriptor BasisFunctionIndexer::getBasisFunctionDescriptor(Mesh::E
 BasisFunctionDescriptor BasisFunctionIndexer::getBasisFunctionDescriptor(uint32_t basisFunctionIndex) const
 {
     assert(basisFunctionIndex < getNumOfBasisFunctions());
+    if (m_basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        return getBasisFunctionDescriptorHierarchical(basisFunctionIndex);
+    }
     if (basisFunctionIndex < m_numOfNodalBasisFunctions)
     {
         return NodalBasisFunctionDescriptor(basisFunctionIndex);
@@ -71,19 +117,38 @@ BasisFunctionDescriptor BasisFunctionIndexer::getBasisFunctionDescriptor(uint32_
         return SideBasisFunctionDescriptor(basisFunctionIndex / (m_p - 1), basisFunctionIndex % (m_p - 1) + 2);
     }
     basisFunctionIndex -= m_numOfSideBasisFunctions;
-    for (int i = 1; i < m_accumulatedNumsOfInternalBasisFunctions.size(); i++)
+    /* The element is the last one whose internal basis functions start at or before the index */
+    const auto it = std::upper_bound(m_accumulatedNumsOfInternalBasisFunctions.begin(), m_accumulatedNumsOfInternalBasisFunctions.end(), basisFunctionIndex);
+    assert(it != m_accumulatedNumsOfInternalBasisFunctions.begin() && it != m_accumulatedNumsOfInternalBasisFunctions.end());
+    const uint32_t elementIdx = std::distance(m_accumulatedNumsOfInternalBasisFunctions.begin(), it) - 1;
+    const uint32_t internalShapeFunctionIdx = basisFunctionIndex - m_accumulatedNumsOfInternalBasisFunctions.at(elementIdx);
+    const Element& element = m_mesh->getElement(elementIdx);
+    const InternalShapeFunctionDescriptor desc = m_shapeFunctionIndexer.getInternalShapeFunctionDescriptor(element.getElementType(), internalShapeFunctionIdx);
+    return InternalBasisFunctionDescriptor(elementIdx, desc.k, desc.l);
+}
+
+BasisFunctionDescriptor BasisFunctionIndexer::getBasisFunctionDescriptorHierarchical(uint32_t basisFunctionIndex) const
+{
+    if (basisFunctionIndex < m_numOfNodalBasisFunctions)
     {
-        if (basisFunctionIndex < m_accumulatedNumsOfInternalBasisFunctions.at(i))
-        {
-            const uint32_t elementIdx = i - 1;
-            const uint32_t internalShapeFunctionIdx = basisFunctionIndex - m_accumulatedNumsOfInternalBasisFunctions.at(elementIdx);
-            const Element& element = m_mesh->getElement(elementIdx);
-            const InternalShapeFunctionDescriptor desc = m_shapeFunctionIndexer.getInternalShapeFunctionDescriptor(element.getElementType(), internalShapeFunctionIdx);
-            return InternalBasisFunctionDescriptor(elementIdx, desc.k, desc.l);
-        }
+        return NodalBasisFunctionDescriptor(basisFunctionIndex);
     }
-    assert(false);
-    return BasisFunctionDescriptor{};
+    const auto degreeIt = std::upper_bound(m_degreeOffsets.begin(), m_degreeOffsets.end(), basisFunctionIndex);
+    const uint32_t degree = std::distance(m_degreeOffsets.begin(), degreeIt) - 1;
+    basisFunctionIndex -= m_degreeOffsets.at(degree);
+    const uint32_t numOfSides = m_mesh->getNumOfSides();
+    if (basisFunctionIndex < numOfSides)
+    {
+        return SideBasisFunctionDescriptor(basisFunctionIndex, degree);
+    }
+    basisFunctionIndex -= numOfSides;
+    const auto& accumulatedNums = m_accumulatedNumsOfInternalBasisFunctionsOfDegree.at(degree);
+    const auto it = std::upper_bound(accumulatedNums.begin(), accumulatedNums.end(), basisFunctionIndex);
+    assert(it != accumulatedNums.begin() && it != accumulatedNums.end());
+    const uint32_t elementIdx = std::distance(accumulatedNums.begin(), it) - 1;
+    const ElementType elementType = m_mesh->getElement(elementIdx).getElementType();
+    const InternalShapeFunctionDescriptor& desc = m_internalShapeFunctionsOfDegree[elementType][degree].at(basisFunctionIndex - accumulatedNums.at(elementIdx));
+    return InternalBasisFunctionDescriptor(elementIdx, desc.k, desc.l);
 }
 
 uint32_t BasisFunctionIndexer::getBasisFunctionIndexVisit(Mesh::ElementIndex elementIdx, const NodalShapeFunctionDescriptor& desc) const
@@ -110,6 +175,10 @@ uint32_t BasisFunctionIndexer::getBasisFunctionIndexVisit(const NodalBasisFuncti
 
 uint32_t BasisFunctionIndexer::getBasisFunctionIndexVisit(const SideBasisFunctionDescriptor& desc) const
 {
+    if (m_basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        return m_degreeOffsets.at(desc.k) + desc.sideIdx;
+    }
     uint32_t res = m_numOfNodalBasisFunctions;
     res += desc.sideIdx * (m_p-1);
     res += desc.k - 2;
@@ -118,10 +187,60 @@ uint32_t BasisFunctionIndexer::getBasisFunctionIndexVisit(const SideBasisFunctio
 
 uint32_t BasisFunctionIndexer::getBasisFunctionIndexVisit(const InternalBasisFunctionDescriptor& desc) const
 {
+    if (m_basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        const ElementType elementType = m_mesh->getElement(desc.elementIdx).getElementType();
+        const InternalShapeFunctionDescriptor shapeFunctionDesc(desc.k, desc.l);
+        const uint32_t degree = m_shapeFunctionIndexer.getInternalShapeFunctionDegree(elementType, shapeFunctionDesc);
+        const uint32_t internalShapeFunctionIdx = m_shapeFunctionIndexer.getInternalShapeFunctionIndex(elementType, shapeFunctionDesc);
+        uint32_t res = m_degreeOffsets.at(degree) + m_mesh->getNumOfSides();
+        res += m_accumulatedNumsOfInternalBasisFunctionsOfDegree.at(degree).at(desc.elementIdx);
+        res += m_internalShapeFunctionPositionWithinDegree[elementType].at(internalShapeFunctionIdx);
+        return res;
+    }
     uint32_t res = m_numOfNodalBasisFunctions + m_numOfSideBasisFunctions;
     res += m_accumulatedNumsOfInternalBasisFunctions.at(desc.elementIdx);
     const Element& element = m_mesh->getElement(desc.elementIdx);
     res += m_shapeFunctionIndexer.getInternalShapeFunctionIndex(element.getElementType(), InternalShapeFunctionDescriptor(desc.k, desc.l));
     return res;
 }
+
+std::vector<uint32_t> getSubToSuperBasisFunctionIndices(const FemContext& ctx, uint32_t p)
+{
+    assert(p >= 1 && p <= ctx.p);
+    const BasisFunctionIndexer subBasisFunctionIndexer(FemContext(ctx.mesh, p, ctx.polynomialSpaceType, ctx.basisFunctionOrdering));
+    std::vector<uint32_t> res(subBasisFunctionIndexer.getNumOfBasisFunctions());
+    if (ctx.basisFunctionOrdering == BasisFunctionOrdering_Hierarchical)
+    {
+        std::iota(res.begin(), res.end(), 0);
+        return res;
+    }
+    const BasisFunctionIndexer superBasisFunctionIndexer(ctx);
+    for (int i = 0; i < res.size(); i++)
+    {
+        res[i] = superBasisFunctionIndexer.getBasisFunctionIndex(subBasisFunctionIndexer.getBasisFunctionDescriptor(i));
+    }
+    return res;
+}
+
+std::vector<std::vector<uint32_t>> getSideAndInternalBasisFunctionBlocks(const FemContext& ctx)
+{
+    const BasisFunctionIndexer basisFunctionIndexer(ctx);
+    const uint32_t numOfSides = ctx.mesh->getNumOfSides();
+    std::vector<std::vector<uint32_t>> res(ctx.p > 1 ? numOfSides + ctx.mesh->getNumOfElements() : 0);
+    for (uint32_t i = 0; i < basisFunctionIndexer.getNumOfBasisFunctions(); i++)
+    {
+        const BasisFunctionDescriptor desc = basisFunctionIndexer.getBasisFunctionDescriptor(i);
+        if (const auto* sideDesc = std::get_if<SideBasisFunctionDescriptor>(&desc))
+        {
+            res[sideDesc->sideIdx].push_back(i);
+        }
+        else if (const auto* internalDesc = std::get_if<InternalBasisFunctionDescriptor>(&desc))
+        {
+            res[numOfSides + internalDesc->elementIdx].push_back(i);
+        }
+    }
+    std::erase_if(res, [](const auto& block) { return block.empty(); });
+    return res;
+}
 } // namespace fem
@@ -30,10 +30,14 @@ private:
     uint32_t getBasisFunctionIndexVisit(const SideBasisFunctionDescriptor& desc) const;
     uint32_t getBasisFunctionIndexVisit(const InternalBasisFunctionDescriptor& desc) const;
 
+    void initializeHierarchicalOrdering();
+    BasisFunctionDescriptor getBasisFunctionDescriptorHierarchical(uint32_t basisFunctionIndex) const;
+
 private:
     std::shared_ptr<Mesh> m_mesh;
     uint32_t m_p;
     PolynomialSpaceType m_polynomialSpaceType;
+    BasisFunctionOrdering m_basisFunctionOrdering;
 
     uint32_t m_numOfNodalBasisFunctions;
     uint32_t m_numOfSideBasisFunctions;
@@ -41,5 +45,19 @@ private:
     uint32_t m_numOfBasisFunctions;
 
     ShapeFunctionIndexer m_shapeFunctionIndexer;
+
+    /* Hierarchical ordering only, indexed by degree */
+    std::vector<uint32_t> m_degreeOffsets;
+    std::vector<std::vector<uint32_t>> m_accumulatedNumsOfInternalBasisFunctionsOfDegree;
+    std::vector<std::vector<InternalShapeFunctionDescriptor>> m_internalShapeFunctionsOfDegree[2];
+    std::vector<uint32_t> m_internalShapeFunctionPositionWithinDegree[2];
 };
+
+/* Index in the basis of degree ctx.p of each basis function of degree p <= ctx.p.
+ * With the hierarchical ordering this is the identity on the first basis functions. */
+std::vector<uint32_t> getSubToSuperBasisFunctionIndices(const FemContext& ctx, uint32_t p);
+
+/* Indices of the side basis functions of each side followed by those of the internal basis functions of each element.
+ * The nodal basis functions are not included. */
+std::vector<std::vector<uint32_t>> getSideAndInternalBasisFunctionBlocks(const FemContext& ctx);
 } // namespace fem
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <ostream>
+
+namespace fem
+{
+/*
+ * Standard: the nodal basis functions, then the side basis functions side by side and then the internal basis
+ * functions element by element.
+ * Hierarchical: the basis functions are grouped by degree, so that the basis functions of degree at most q come
+ * first and are ordered as in the hierarchical basis of degree q. Within a degree the nodal basis functions come
+ * first, then the side basis functions and then the internal basis functions element by element.
+ */
+enum BasisFunctionOrdering
+{
+    BasisFunctionOrdering_Standard,
+    BasisFunctionOrdering_Hierarchical
+};
+
+inline std::ostream& operator<<(std::ostream& out, BasisFunctionOrdering basisFunctionOrdering)
+{
+    if (basisFunctionOrdering == BasisFunctionOrdering_Standard)
+    {
+        out << "standard";
+    }
+    else
+    {
+        out << "hierarchical";
+    }
+    return out;
+}
+} // namespace fem
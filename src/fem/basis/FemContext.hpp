@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <memory>
 
+#include "fem/basis/BasisFunctionOrdering.hpp"
 #include "fem/basis/PolynomialSpaceType.hpp"
 #include "fem/domain/Mesh.hpp"
 
@@ -14,11 +15,14 @@ struct FemContext
     std::shared_ptr<Mesh> mesh;
     uint32_t p;
     PolynomialSpaceType polynomialSpaceType;
+    BasisFunctionOrdering basisFunctionOrdering;
 
-    FemContext(const std::shared_ptr<Mesh>& mesh, uint32_t p, PolynomialSpaceType polynomialSpaceType)
+    FemContext(const std::shared_ptr<Mesh>& mesh, uint32_t p, PolynomialSpaceType polynomialSpaceType,
+               BasisFunctionOrdering basisFunctionOrdering = BasisFunctionOrdering_Standard)
         : mesh(mesh)
         , p(p)
         , polynomialSpaceType(polynomialSpaceType)
+        , basisFunctionOrdering(basisFunctionOrdering)
     {
         assert(mesh != nullptr);
     }
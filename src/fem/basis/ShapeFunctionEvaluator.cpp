@@ -1,34 +1,42 @@
 #include "fem/basis/ShapeFunctionEvaluator.hpp"
 
+#include <type_traits>
 #include <vector>
 
 namespace fem
 {
-ShapeFunctionEvaluator::ShapeFunctionEvaluator(const ShapeFunctionFactory& shapeFunctionFactory)
+template<typename Scalar>
+BasicShapeFunctionEvaluator<Scalar>::BasicShapeFunctionEvaluator(const ShapeFunctionFactory& shapeFunctionFactory)
     : m_shapeFunctionFactory(shapeFunctionFactory)
 {
 }
 
-mpq_class ShapeFunctionEvaluator::evaluate(ElementType elementType, const ShapeFunctionDescriptor& descriptor, const Vector2mpq& x) const
+template<typename Scalar>
+Scalar BasicShapeFunctionEvaluator<Scalar>::evaluate(ElementType elementType, const ShapeFunctionDescriptor& descriptor, const Eigen::Vector2<Scalar>& x) const
 {
     const auto& cache = m_cache[elementType];
-    if (cache.contains(descriptor) && cache.at(descriptor).contains(x))
+    if (const auto it = cache.find(descriptor); it != cache.end())
     {
-        return cache.at(descriptor).at(x);
-    }
-    else
-    {
-        const Polynomial2D& shapeFn = m_shapeFunctionFactory.getShapeFunction(elementType, descriptor);
-        return shapeFn(x);
+        if (const auto pointIt = it->second.find(x); pointIt != it->second.end())
+        {
+            return pointIt->second;
+        }
     }
+    const BasicPolynomial2D<Scalar>& shapeFn = getShapeFunction(elementType, descriptor);
+    return shapeFn(x);
 }
 
-void ShapeFunctionEvaluator::preEvaluate(ElementType elementType, const std::vector<Vector2mpq>& points)
+template<typename Scalar>
+void BasicShapeFunctionEvaluator<Scalar>::preEvaluate(ElementType elementType, const std::vector<Eigen::Vector2<Scalar>>& points)
 {
     auto& cache = m_cache[elementType];
     std::vector<ShapeFunctionDescriptor> descs;
     for (const auto& [desc, shapeFn] : m_shapeFunctionFactory.getShapeFunctions(elementType))
     {
+        if constexpr (!std::is_same_v<Scalar, mpq_class>)
+        {
+            m_shapeFunctions[elementType].emplace(desc, convertPolynomial<Scalar>(shapeFn));
+        }
         cache.emplace(desc, PointEvalMap{});
         descs.push_back(desc);
     }
@@ -36,7 +44,7 @@ void ShapeFunctionEvaluator::preEvaluate(ElementType elementType, const std::vec
     for (int i = 0; i < descs.size(); i++)
     {
         const auto& desc = descs[i];
-        const Polynomial2D& shapeFn = m_shapeFunctionFactory.getShapeFunction(elementType, desc);
+        const BasicPolynomial2D<Scalar>& shapeFn = getShapeFunction(elementType, desc);
         auto& pointEvalMap = cache.at(desc);
         for (const auto& x : points)
         {
@@ -44,4 +52,22 @@ void ShapeFunctionEvaluator::preEvaluate(ElementType elementType, const std::vec
         }
     }
 }
+
+template<typename Scalar>
+const BasicPolynomial2D<Scalar>& BasicShapeFunctionEvaluator<Scalar>::getShapeFunction(ElementType elementType, const ShapeFunctionDescriptor& descriptor) const
+{
+    if constexpr (std::is_same_v<Scalar, mpq_class>)
+    {
+        return m_shapeFunctionFactory.getShapeFunction(elementType, descriptor);
+    }
+    else
+    {
+        return m_shapeFunctions[elementType].at(descriptor);
+    }
+}
+
+template class BasicShapeFunctionEvaluator<mpq_class>;
+template class BasicShapeFunctionEvaluator<mpf_class>;
+template class BasicShapeFunctionEvaluator<double>;
+template class BasicShapeFunctionEvaluator<long double>;
 } // namespace fem
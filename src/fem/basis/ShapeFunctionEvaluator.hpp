@@ -11,26 +11,38 @@
 
 namespace fem
 {
-class ShapeFunctionEvaluator
+/*
+ * For scalar types other than mpq_class the shape functions are rounded copies made by preEvaluate, so it has to be
+ * called for an element type before evaluating its shape functions.
+ */
+template<typename Scalar>
+class BasicShapeFunctionEvaluator
 {
 public:
-    explicit ShapeFunctionEvaluator(const ShapeFunctionFactory& shapeFunctionFactory);
-    ShapeFunctionEvaluator(ShapeFunctionFactory&& shapeFunctionFactory) = delete;
+    explicit BasicShapeFunctionEvaluator(const ShapeFunctionFactory& shapeFunctionFactory);
+    BasicShapeFunctionEvaluator(ShapeFunctionFactory&& shapeFunctionFactory) = delete;
 
-    mpq_class evaluate(ElementType elementType, const ShapeFunctionDescriptor& descriptor, const Vector2mpq& x) const;
-    void preEvaluate(ElementType elementType, const std::vector<Vector2mpq>& points);
+    Scalar evaluate(ElementType elementType, const ShapeFunctionDescriptor& descriptor, const Eigen::Vector2<Scalar>& x) const;
+    void preEvaluate(ElementType elementType, const std::vector<Eigen::Vector2<Scalar>>& points);
+
+private:
+    const BasicPolynomial2D<Scalar>& getShapeFunction(ElementType elementType, const ShapeFunctionDescriptor& descriptor) const;
 
 private:
     const ShapeFunctionFactory& m_shapeFunctionFactory;
+    /* Empty for mpq_class */
+    std::unordered_map<ShapeFunctionDescriptor, BasicPolynomial2D<Scalar>> m_shapeFunctions[2];
 
-    struct Vector2mpqCompare
+    struct Vector2Compare
     {
-        bool operator()(const Vector2mpq& lhs, const Vector2mpq& rhs) const
+        bool operator()(const Eigen::Vector2<Scalar>& lhs, const Eigen::Vector2<Scalar>& rhs) const
         {
             return lhs(0) != rhs(0) ? lhs(0) < rhs(0) : lhs(1) < rhs(1);
         }
     };
-    using PointEvalMap = std::map<Vector2mpq, mpq_class, Vector2mpqCompare>;
+    using PointEvalMap = std::map<Eigen::Vector2<Scalar>, Scalar, Vector2Compare>;
     std::unordered_map<ShapeFunctionDescriptor, PointEvalMap> m_cache[2];
 };
+
+using ShapeFunctionEvaluator = BasicShapeFunctionEvaluator<mpq_class>;
 } // namespace fem
@@ -5,6 +5,46 @@
 
 namespace fem
 {
+QuadShapeFunctionFactorization getQuadShapeFunctionFactorization(const ShapeFunctionDescriptor& descriptor)
+{
+    if (const auto* desc = std::get_if<NodalShapeFunctionDescriptor>(&descriptor))
+    {
+        assert(desc->nodeIdx < 4);
+        const uint32_t xFactorIdx = (desc->nodeIdx == 1 || desc->nodeIdx == 2) ? 1 : 0;
+        const uint32_t yFactorIdx = (desc->nodeIdx >= 2) ? 1 : 0;
+        return {xFactorIdx, yFactorIdx, 1};
+    }
+    else if (const auto* desc = std::get_if<SideShapeFunctionDescriptor>(&descriptor))
+    {
+        assert(desc->sideIdx < 4);
+        assert(desc->k >= 2);
+        const int reflectionSign = (desc->k % 2 == 0) ? 1 : -1;
+        if (desc->sideIdx == 0)
+        {
+            return {desc->k, 0, 1};
+        }
+        else if (desc->sideIdx == 1)
+        {
+            return {1, desc->k, 1};
+        }
+        else if (desc->sideIdx == 2)
+        {
+            return {desc->k, 1, reflectionSign};
+        }
+        else
+        {
+            return {0, desc->k, reflectionSign};
+        }
+    }
+    else
+    {
+        const auto& internalDesc = std::get<InternalShapeFunctionDescriptor>(descriptor);
+        assert(internalDesc.k >= 2);
+        assert(internalDesc.l >= 2);
+        return {internalDesc.k, internalDesc.l, 1};
+    }
+}
+
 const Polynomial2D& ShapeFunctionFactory::getShapeFunction(ElementType elementType, const ShapeFunctionDescriptor& descriptor) const
 {
     assert(m_shapeFunctions[elementType].contains(descriptor));
@@ -29,6 +69,7 @@ void ShapeFunctionFactory::createShapeFunctions(ElementType elementType, uint32_
     {
         createTriShapeFunctions(p);
     }
+    m_referenceMomentTables[elementType] = ReferenceMomentTable(elementType, 2 * p);
 
     /* Free up temporary memory */
     m_legendrePolynomials.clear();
@@ -43,6 +84,12 @@ void ShapeFunctionFactory::createQuadShapeFunctions(int p)
     createLegendrePolynomials(p);
     createPhis(p);
 
+    m_quadShapeFunctionFactors = {mpq_class("1/2") * Polynomial1D("1-t"), mpq_class("1/2") * Polynomial1D("1+t")};
+    for (int k = 2; k <= p; k++)
+    {
+        m_quadShapeFunctionFactors.push_back(m_phis.at(k));
+    }
+
     std::vector<ShapeFunctionDescriptor> descs;
     for (int nodeIdx = 0; nodeIdx < 4; nodeIdx++)
     {
@@ -2,13 +2,28 @@
 
 #include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 #include "fem/basis/ShapeFunctionDescriptor.hpp"
 #include "fem/domain/Element.hpp"
 #include "fem/math/Polynomial.hpp"
+#include "fem/math/polynomial/ReferenceMomentTable.hpp"
 
 namespace fem
 {
+/*
+ * A quad shape function is sign * f_xFactorIdx(x) * f_yFactorIdx(y), where f_0(t) = (1-t)/2, f_1(t) = (1+t)/2 and
+ * f_k = phi_k for k >= 2. The sign comes from phi_k(-t) = (-1)^k phi_k(t) on the sides 2 and 3.
+ */
+struct QuadShapeFunctionFactorization
+{
+    uint32_t xFactorIdx;
+    uint32_t yFactorIdx;
+    int sign;
+};
+
+QuadShapeFunctionFactorization getQuadShapeFunctionFactorization(const ShapeFunctionDescriptor& descriptor);
+
 class ShapeFunctionFactory
 {
 public:
@@ -20,6 +35,10 @@ public:
     const Polynomial2D& getShapeFunctionDerivative(ElementType elementType, const ShapeFunctionDescriptor& descriptor, char variable) const;
 
     const auto& getShapeFunctions(ElementType elementType) const { return m_shapeFunctions[elementType]; }
+    /* Covers all monomials of products of two shape functions or their derivatives */
+    const ReferenceMomentTable& getReferenceMomentTable(ElementType elementType) const { return m_referenceMomentTables[elementType]; }
+    /* The 1D factors f_0, ..., f_p of the quad shape functions, see QuadShapeFunctionFactorization */
+    const std::vector<Polynomial1D>& getQuadShapeFunctionFactors() const { return m_quadShapeFunctionFactors; }
 
 private:
     void createQuadShapeFunctions(int p);
@@ -47,6 +66,8 @@ private:
 private:
     std::unordered_map<ShapeFunctionDescriptor, Polynomial2D> m_shapeFunctions[2];
     std::unordered_map<ShapeFunctionDescriptor, std::unordered_map<char, Polynomial2D>> m_shapeFunctionDerivatives[2];
+    ReferenceMomentTable m_referenceMomentTables[2];
+    std::vector<Polynomial1D> m_quadShapeFunctionFactors;
 
     std::unordered_map<uint32_t, Polynomial1D> m_legendrePolynomials;
     std::unordered_map<uint32_t, std::unordered_map<char, Polynomial2D>> m_shiftedLegendrePolynomials2D;
@@ -1,5 +1,6 @@
 #include "fem/basis/ShapeFunctionIndexer.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 namespace fem
@@ -160,6 +161,32 @@ uint32_t ShapeFunctionIndexer::getInternalShapeFunctionIndex(ElementType element
     }
 }
 
+uint32_t ShapeFunctionIndexer::getInternalShapeFunctionDegree(ElementType elementType, const InternalShapeFunctionDescriptor& descriptor) const
+{
+    if (elementType == ElementType_Parallelogram)
+    {
+        if (m_polynomialSpaceType == PolynomialSpaceType_Product)
+        {
+            return std::max(descriptor.k, descriptor.l);
+        }
+        else
+        {
+            return descriptor.k + descriptor.l;
+        }
+    }
+    else
+    {
+        if (m_polynomialSpaceType == PolynomialSpaceType_Product)
+        {
+            return std::max(descriptor.k, descriptor.l) + 2;
+        }
+        else
+        {
+            return descriptor.k + descriptor.l + 3;
+        }
+    }
+}
+
 InternalShapeFunctionDescriptor ShapeFunctionIndexer::getInternalShapeFunctionDescriptorTriangle(uint32_t internalShapeFunctionIdx) const
 {
     if (m_polynomialSpaceType == PolynomialSpaceType_Product)
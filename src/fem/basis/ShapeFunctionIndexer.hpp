@@ -23,6 +23,8 @@ public:
     uint32_t getShapeFunctionIndex(ElementType elementType, const ShapeFunctionDescriptor& descriptor) const;
     InternalShapeFunctionDescriptor getInternalShapeFunctionDescriptor(ElementType elementType, uint32_t internalShapeFunctionIdx) const;
     uint32_t getInternalShapeFunctionIndex(ElementType elementType, const InternalShapeFunctionDescriptor& descriptor) const;
+    /* Lowest p for which the shape function belongs to the basis */
+    uint32_t getInternalShapeFunctionDegree(ElementType elementType, const InternalShapeFunctionDescriptor& descriptor) const;
 
 private:
     InternalShapeFunctionDescriptor getInternalShapeFunctionDescriptorTriangle(uint32_t internalShapeFunctionIdx) const;
@@ -3,37 +3,65 @@
 #include "fem/basis/BasisFunctionFactory.hpp"
 #include "fem/basis/BasisFunctionIndexer.hpp"
 #include "fem/basis/ShapeFunctionIndexer.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
-mpq_class evaluateTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, const Vector2mpq& x, const ShapeFunctionEvaluator& shapeFunctionEvaluator)
+template<typename Scalar>
+BasicElementTrialFunction<Scalar>::BasicElementTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, Mesh::ElementIndex elementIdx)
 {
-    mpq_class res = 0;
     const BasisFunctionIndexer basisFunctionIndexer(ctx);
     const ShapeFunctionIndexer shapeFunctionIndexer(ctx.p, ctx.polynomialSpaceType);
     const Mesh& mesh = *ctx.mesh;
-    const Mesh::ElementIndex elementIdx = getIndexOfElementContainingPoint(mesh, x);
-    const Element& element = mesh.getElement(elementIdx);
-    const ElementType elementType = element.getElementType();
-    const AffineMap Finv = element.getReferenceElementMap().inverse();
-    for (int shapeFnIdx = 0; shapeFnIdx < basisFunctionIndexer.getNumOfShapeFunctions(elementIdx); shapeFnIdx++)
+    m_elementType = mesh.getElement(elementIdx).getElementType();
+    const uint32_t numOfShapeFunctions = basisFunctionIndexer.getNumOfShapeFunctions(elementIdx);
+    m_descriptors.reserve(numOfShapeFunctions);
+    m_localCoefficients.resize(numOfShapeFunctions);
+    for (int shapeFnIdx = 0; shapeFnIdx < numOfShapeFunctions; shapeFnIdx++)
     {
         const uint32_t basisFnIdx = basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFnIdx);
-        const auto desc = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx);
-        mpq_class value = shapeFunctionEvaluator.evaluate(elementType, desc, Finv(x));
+        const auto desc = shapeFunctionIndexer.getShapeFunctionDescriptor(m_elementType, shapeFnIdx);
+        m_descriptors.push_back(desc);
+        m_localCoefficients(shapeFnIdx) = convertRational<Scalar>(coefficients(basisFnIdx));
         if (const auto* descp = std::get_if<SideShapeFunctionDescriptor>(&desc))
         {
             const auto adjacentElementIdx = mesh.getIndexOfAdjacentElement(elementIdx, descp->sideIdx);
             if (adjacentElementIdx.has_value() && elementIdx < adjacentElementIdx.value() && descp->k % 2 != 0)
             {
-                value *= -1;
+                m_localCoefficients(shapeFnIdx) *= -1;
             }
         }
-        res += coefficients(basisFnIdx) * value;
+    }
+}
+
+template<typename Scalar>
+Scalar BasicElementTrialFunction<Scalar>::evaluate(const Eigen::Vector2<Scalar>& x, const BasicShapeFunctionEvaluator<Scalar>& shapeFunctionEvaluator) const
+{
+    Scalar res = 0;
+    for (int shapeFnIdx = 0; shapeFnIdx < m_descriptors.size(); shapeFnIdx++)
+    {
+        const Scalar& coefficient = m_localCoefficients(shapeFnIdx);
+        if (coefficient != 0)
+        {
+            res += coefficient * shapeFunctionEvaluator.evaluate(m_elementType, m_descriptors[shapeFnIdx], x);
+        }
     }
     return res;
 }
 
+template class BasicElementTrialFunction<mpq_class>;
+template class BasicElementTrialFunction<mpf_class>;
+template class BasicElementTrialFunction<double>;
+template class BasicElementTrialFunction<long double>;
+
+mpq_class evaluateTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, const Vector2mpq& x, const ShapeFunctionEvaluator& shapeFunctionEvaluator)
+{
+    const Mesh& mesh = *ctx.mesh;
+    const Mesh::ElementIndex elementIdx = getIndexOfElementContainingPoint(mesh, x);
+    const ElementTrialFunction elementTrialFunction(ctx, coefficients, elementIdx);
+    return elementTrialFunction.evaluate(mesh.getInverseReferenceElementMap(elementIdx)(x), shapeFunctionEvaluator);
+}
+
 mpq_class integrateTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, const ShapeFunctionFactory& shapeFunctionFactory)
 {
     mpq_class res = 0;
@@ -44,13 +72,13 @@ mpq_class integrateTrialFunction(const FemContext& ctx, const VectorXmpq& coeffi
     {
         const Element& element = mesh.getElement(elementIdx);
         const ElementType elementType = element.getElementType();
-        const mpq_class detA = element.getReferenceElementMap().A.determinant();
+        const mpq_class& detA = mesh.getElementGeometry(elementIdx).detA;
         for (int shapeFnIdx = 0; shapeFnIdx < shapeFunctionIndexer.getNumOfShapeFunctions(elementType); shapeFnIdx++)
         {
             const uint32_t basisFnIdx = basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFnIdx);
             const auto desc = shapeFunctionIndexer.getShapeFunctionDescriptor(elementType, shapeFnIdx);
             const Polynomial2D& shapeFn = shapeFunctionFactory.getShapeFunction(elementType, desc);
-            mpq_class integral = integrateOverReferenceElement(shapeFn, elementType);
+            mpq_class integral = integrateOverReferenceElement(shapeFn, shapeFunctionFactory.getReferenceMomentTable(elementType));
             if (const auto* descp = std::get_if<SideShapeFunctionDescriptor>(&desc))
             {
                 const auto adjacentElementIdx = mesh.getIndexOfAdjacentElement(elementIdx, descp->sideIdx);
@@ -83,8 +111,7 @@ mpq_class evaluateTrialFunction(const FemContext& ctx, const VectorXmpq& coeffic
     const BasisFunctionIndexer basisFunctionIndexer(ctx);
     const Mesh& mesh = *ctx.mesh;
     const Mesh::ElementIndex elementIdx = getIndexOfElementContainingPoint(mesh, x);
-    const Element& element = mesh.getElement(elementIdx);
-    const AffineMap Finv = element.getReferenceElementMap().inverse();
+    const AffineMap& Finv = mesh.getInverseReferenceElementMap(elementIdx);
     for (int shapeFunctionIdx = 0; shapeFunctionIdx < basisFunctionIndexer.getNumOfShapeFunctions(elementIdx); shapeFunctionIdx++)
     {
         const uint32_t basisFunctionIdx = basisFunctionIndexer.getBasisFunctionIndex(elementIdx, shapeFunctionIdx);
@@ -1,12 +1,39 @@
 #pragma once
 
+#include <vector>
+
 #include "fem/basis/FemContext.hpp"
 #include "fem/basis/ShapeFunctionEvaluator.hpp"
+#include "fem/basis/ShapeFunctionDescriptor.hpp"
 #include "fem/basis/ShapeFunctionFactory.hpp"
+#include "fem/domain/Mesh.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
+/*
+ * Restriction of a trial function to one element. The coefficients of the element's shape functions, including
+ * the side orientation signs, are gathered once so that evaluation needs no indexing or point location. They are
+ * rounded to Scalar, see convertRational.
+ */
+template<typename Scalar>
+class BasicElementTrialFunction
+{
+public:
+    explicit BasicElementTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, Mesh::ElementIndex elementIdx);
+
+    /* x is in the coordinates of the reference element */
+    Scalar evaluate(const Eigen::Vector2<Scalar>& x, const BasicShapeFunctionEvaluator<Scalar>& shapeFunctionEvaluator) const;
+    const Eigen::VectorX<Scalar>& getLocalCoefficients() const { return m_localCoefficients; }
+
+private:
+    ElementType m_elementType;
+    std::vector<ShapeFunctionDescriptor> m_descriptors;
+    Eigen::VectorX<Scalar> m_localCoefficients;
+};
+
+using ElementTrialFunction = BasicElementTrialFunction<mpq_class>;
+
 mpq_class evaluateTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, const Vector2mpq& x, const ShapeFunctionEvaluator& shapeFunctionEvaluator);
 mpq_class integrateTrialFunction(const FemContext& ctx, const VectorXmpq& coefficients, const ShapeFunctionFactory& shapeFunctionFactory);
 void normalizeTrialFunction(const FemContext& ctx, VectorXmpq& coefficients, const ShapeFunctionFactory& shapeFunctionFactory);
@@ -232,4 +232,79 @@ TEST_F(BasisFunctionIndexerTest, TrunkSpace)
         checkBasisFunctions(p, PolynomialSpaceType_Trunk);
     }
 }
+
+TEST_F(BasisFunctionIndexerTest, GetBasisFunctionDescriptor)
+{
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const BasisFunctionIndexer indexer(FemContext(mesh, 5, polynomialSpaceType));
+        for (uint32_t i = 0; i < indexer.getNumOfBasisFunctions(); i++)
+        {
+            EXPECT_EQ(indexer.getBasisFunctionIndex(indexer.getBasisFunctionDescriptor(i)), i);
+        }
+    }
+}
+
+TEST_F(BasisFunctionIndexerTest, SubToSuperBasisFunctionIndices)
+{
+    const uint32_t p_max = 5;
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const FemContext ctx(mesh, p_max, polynomialSpaceType);
+        const BasisFunctionIndexer superIndexer(ctx);
+        for (uint32_t p = 1; p <= p_max; p++)
+        {
+            const BasisFunctionIndexer subIndexer(FemContext(mesh, p, polynomialSpaceType));
+            const std::vector<uint32_t> subToSuperIndex = getSubToSuperBasisFunctionIndices(ctx, p);
+            ASSERT_EQ(subToSuperIndex.size(), subIndexer.getNumOfBasisFunctions());
+            EXPECT_EQ(std::set<uint32_t>(subToSuperIndex.begin(), subToSuperIndex.end()).size(), subToSuperIndex.size());
+            for (uint32_t i = 0; i < subToSuperIndex.size(); i++)
+            {
+                EXPECT_EQ(superIndexer.getBasisFunctionDescriptor(subToSuperIndex[i]), subIndexer.getBasisFunctionDescriptor(i));
+            }
+        }
+    }
+}
+
+TEST_F(BasisFunctionIndexerTest, HierarchicalOrdering)
+{
+    const uint32_t p_max = 6;
+    for (const PolynomialSpaceType polynomialSpaceType : {PolynomialSpaceType_Product, PolynomialSpaceType_Trunk})
+    {
+        const FemContext ctx(mesh, p_max, polynomialSpaceType, BasisFunctionOrdering_Hierarchical);
+        const BasisFunctionIndexer indexer(ctx);
+        const BasisFunctionIndexer standardIndexer(FemContext(mesh, p_max, polynomialSpaceType));
+        ASSERT_EQ(indexer.getNumOfBasisFunctions(), standardIndexer.getNumOfBasisFunctions());
+        std::set<uint32_t> standardIndices;
+        for (uint32_t i = 0; i < indexer.getNumOfBasisFunctions(); i++)
+        {
+            const BasisFunctionDescriptor desc = indexer.getBasisFunctionDescriptor(i);
+            EXPECT_EQ(indexer.getBasisFunctionIndex(desc), i);
+            standardIndices.insert(standardIndexer.getBasisFunctionIndex(desc));
+        }
+        EXPECT_EQ(standardIndices.size(), indexer.getNumOfBasisFunctions());
+        for (uint32_t elementIdx = 0; elementIdx < mesh->getNumOfElements(); elementIdx++)
+        {
+            for (uint32_t shapeFunctionIdx = 0; shapeFunctionIdx < indexer.getNumOfShapeFunctions(elementIdx); shapeFunctionIdx++)
+            {
+                EXPECT_EQ(indexer.getBasisFunctionDescriptor(elementIdx, shapeFunctionIdx), standardIndexer.getBasisFunctionDescriptor(elementIdx, shapeFunctionIdx));
+            }
+        }
+        /* The basis of a lower degree is a leading part of the basis */
+        for (uint32_t p = 1; p <= p_max; p++)
+        {
+            const BasisFunctionIndexer subIndexer(FemContext(mesh, p, polynomialSpaceType, BasisFunctionOrdering_Hierarchical));
+            for (uint32_t i = 0; i < subIndexer.getNumOfBasisFunctions(); i++)
+            {
+                EXPECT_EQ(subIndexer.getBasisFunctionDescriptor(i), indexer.getBasisFunctionDescriptor(i));
+            }
+            const std::vector<uint32_t> subToSuperIndex = getSubToSuperBasisFunctionIndices(ctx, p);
+            ASSERT_EQ(subToSuperIndex.size(), subIndexer.getNumOfBasisFunctions());
+            for (uint32_t i = 0; i < subToSuperIndex.size(); i++)
+            {
+                EXPECT_EQ(subToSuperIndex[i], i);
+            }
+        }
+    }
+}
 } // namespace fem::ut
@@ -123,4 +123,20 @@ TEST(ShapeFunctionFactoryTest, ShapeFunctionsAreCorrect)
     checkTriangleShapeFunctions(f);
     checkShapeFunctionDerivatives(f);
 }
+
+TEST(ShapeFunctionFactoryTest, QuadShapeFunctionsFactorize)
+{
+    const uint32_t p = 5;
+    ShapeFunctionFactory f;
+    f.createShapeFunctions(ElementType_Parallelogram, p);
+    const std::vector<Polynomial1D>& factors = f.getQuadShapeFunctionFactors();
+    ASSERT_EQ(factors.size(), p + 1);
+    for (const auto& [desc, shapeFn] : f.getShapeFunctions(ElementType_Parallelogram))
+    {
+        const QuadShapeFunctionFactorization factorization = getQuadShapeFunctionFactorization(desc);
+        const Polynomial2D xFactor = compose(factors[factorization.xFactorIdx], Polynomial2D("x"));
+        const Polynomial2D yFactor = compose(factors[factorization.yFactorIdx], Polynomial2D("y"));
+        EXPECT_EQ(factorization.sign * (xFactor * yFactor), shapeFn);
+    }
+}
 } // namespace fem::ut
@@ -50,6 +50,42 @@ TEST_F(TrialFunctionTest, EvaluateTrialFunction)
     EXPECT_EQ(evaluateTrialFunction(ctx, coefficients, {mpq_class("0"), mpq_class("2")}, shapeFunctionEvaluator), mpq_class("1/2"));
 }
 
+TEST_F(TrialFunctionTest, ElementTrialFunction)
+{
+    const std::vector<std::pair<Mesh::ElementIndex, Vector2mpq>> points = {
+        {0, {mpq_class("1/2"), mpq_class("-1/5")}},
+        {0, {mpq_class("-3/8"), mpq_class("1")}},
+        {1, {mpq_class("-3/8"), mpq_class("1")}},
+        {1, {mpq_class("1/5"), mpq_class("3/2")}},
+        {1, {mpq_class("0"), mpq_class("2")}}
+    };
+    for (const auto& [elementIdx, x] : points)
+    {
+        const ElementTrialFunction elementTrialFunction(ctx, coefficients, elementIdx);
+        const Vector2mpq xloc = mesh->getInverseReferenceElementMap(elementIdx)(x);
+        EXPECT_EQ(elementTrialFunction.evaluate(xloc, shapeFunctionEvaluator), evaluateTrialFunction(ctx, coefficients, x));
+    }
+}
+
+TEST_F(TrialFunctionTest, ElementTrialFunctionInDouble)
+{
+    BasicShapeFunctionEvaluator<double> shapeFunctionEvaluatorDouble{shapeFunctionFactory};
+    shapeFunctionEvaluatorDouble.preEvaluate(ElementType_Parallelogram, {{0.5, -0.25}});
+    shapeFunctionEvaluatorDouble.preEvaluate(ElementType_Triangle, {});
+    const std::vector<std::pair<Mesh::ElementIndex, Vector2mpq>> points = {
+        {0, {mpq_class(1)/2, mpq_class(-1)/4}},
+        {0, {mpq_class(-3)/8, mpq_class(1)}},
+        {1, {mpq_class(1)/5, mpq_class(1)/3}}
+    };
+    for (const auto& [elementIdx, xloc] : points)
+    {
+        const ElementTrialFunction elementTrialFunction(ctx, coefficients, elementIdx);
+        const BasicElementTrialFunction<double> elementTrialFunctionDouble(ctx, coefficients, elementIdx);
+        const Eigen::Vector2d xlocDouble(xloc(0).get_d(), xloc(1).get_d());
+        EXPECT_NEAR(elementTrialFunctionDouble.evaluate(xlocDouble, shapeFunctionEvaluatorDouble), elementTrialFunction.evaluate(xloc, shapeFunctionEvaluator).get_d(), 1e-14);
+    }
+}
+
 TEST_F(TrialFunctionTest, IntegrateTrialFunction)
 {
     EXPECT_EQ(integrateTrialFunction(ctx, coefficients), mpq_class("55/36") + mpq_class("1/12"));
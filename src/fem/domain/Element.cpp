@@ -38,14 +38,18 @@ bool operator!=(const Element& lhs, const Element& rhs)
 bool isPointInsideElement(const Vector2mpq& point, const Element& element)
 {
     const AffineMap invMap = element.getReferenceElementMap().inverse();
-    const Vector2mpq vertexInLocalCoords = invMap(point);
-    const mpq_class& x = vertexInLocalCoords(0);
-    const mpq_class& y = vertexInLocalCoords(1);
-    if (element.getElementType() == ElementType_Triangle)
+    return isPointInsideReferenceElement(invMap(point), element.getElementType());
+}
+
+bool isPointInsideReferenceElement(const Vector2mpq& point, ElementType elementType)
+{
+    const mpq_class& x = point(0);
+    const mpq_class& y = point(1);
+    if (elementType == ElementType_Triangle)
     {
         return x >= 0 && y >= 0 && x + y <= 1;
     }
-    else if (element.getElementType() == ElementType_Parallelogram)
+    else if (elementType == ElementType_Parallelogram)
     {
         return x >= -1 && x <= 1 && y >= -1 && y <= 1;
     }
@@ -35,6 +35,7 @@ bool areIntersecting(const Element& element1, const Element& element2);
 bool isIntersectionOneNode(const Element& element1, const Element& element2);
 bool isIntersectionOneSide(const Element& element1, const Element& element2);
 bool isPointInsideElement(const Vector2mpq& point, const Element& element);
+bool isPointInsideReferenceElement(const Vector2mpq& point, ElementType elementType);
 bool operator==(const Element& lhs, const Element& rhs);
 bool operator!=(const Element& lhs, const Element& rhs);
 } // namespace fem
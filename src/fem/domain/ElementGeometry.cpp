@@ -0,0 +1,14 @@
+#include "fem/domain/ElementGeometry.hpp"
+
+namespace fem
+{
+ElementGeometry computeElementGeometry(const Element& element)
+{
+    ElementGeometry res;
+    res.F = element.getReferenceElementMap();
+    res.Finv = res.F.inverse();
+    res.detA = res.F.A.determinant();
+    res.M = res.Finv.A * res.Finv.A.transpose();
+    return res;
+}
+} // namespace fem
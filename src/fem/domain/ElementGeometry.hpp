@@ -0,0 +1,19 @@
+#pragma once
+
+#include "fem/domain/Element.hpp"
+#include "fem/math/AffineMap.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/* Quantities of the reference element map F(x) = Ax + b that are needed repeatedly in assembly and evaluation */
+struct ElementGeometry
+{
+    AffineMap F;
+    AffineMap Finv;
+    mpq_class detA;
+    Matrix2mpq M; // A^-1 A^-T
+};
+
+ElementGeometry computeElementGeometry(const Element& element);
+} // namespace fem
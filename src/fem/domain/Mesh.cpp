@@ -1,7 +1,9 @@
 #include "fem/domain/Mesh.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -17,9 +19,12 @@ Mesh::Mesh(const std::vector<Node>& nodes, const std::vector<std::vector<NodeInd
     , m_containsQuadrilateral(false)
 {
     createElements(nodes, elements);
+    computeElementGeometries();
+    buildElementGrid();
     assignGlobalSideIndices();
     updateAdjacentElements();
     validateElements();
+    colorElements();
 }
 
 Mesh::NodeIndex Mesh::getGlobalNodeIndex(ElementIndex elementIdx, NodeIndex localNodeIdx) const
@@ -53,6 +58,38 @@ std::optional<Mesh::ElementIndex> Mesh::getIndexOfAdjacentElement(ElementIndex e
     }
 }
 
+bool Mesh::isPointInsideElement(const Vector2mpq& point, ElementIndex elementIdx) const
+{
+    return isPointInsideReferenceElement(getInverseReferenceElementMap(elementIdx)(point), getElement(elementIdx).getElementType());
+}
+
+std::optional<Mesh::ElementIndex> Mesh::findElementContainingPoint(const Vector2mpq& point) const
+{
+    const double x = point(0).get_d();
+    const double y = point(1).get_d();
+    const ElementGrid& grid = m_elementGrid;
+    if (getNumOfElements() == 0 ||
+        x < grid.boundingBox[0] - grid.tolerance || x > grid.boundingBox[2] + grid.tolerance ||
+        y < grid.boundingBox[1] - grid.tolerance || y > grid.boundingBox[3] + grid.tolerance)
+    {
+        return {};
+    }
+    const std::vector<ElementIndex>& cell = grid.cells[grid.getCellCoordinate(y, 1) * grid.size + grid.getCellCoordinate(x, 0)];
+    for (const ElementIndex elementIdx : cell)
+    {
+        const ElementGrid::BoundingBox& box = grid.elementBoundingBoxes[elementIdx];
+        if (x < box[0] - grid.tolerance || x > box[2] + grid.tolerance || y < box[1] - grid.tolerance || y > box[3] + grid.tolerance)
+        {
+            continue;
+        }
+        if (isPointInsideElement(point, elementIdx))
+        {
+            return elementIdx;
+        }
+    }
+    return {};
+}
+
 void Mesh::createElements(const std::vector<Node>& nodes, const std::vector<std::vector<NodeIndex>>& elements)
 {
     for (const auto& idxs : elements)
@@ -74,6 +111,74 @@ void Mesh::createElements(const std::vector<Node>& nodes, const std::vector<std:
     }
 }
 
+void Mesh::computeElementGeometries()
+{
+    m_elementGeometries.resize(getNumOfElements());
+    #pragma omp parallel for schedule(static)
+    for (int elementIdx = 0; elementIdx < getNumOfElements(); elementIdx++)
+    {
+        m_elementGeometries[elementIdx] = computeElementGeometry(getElement(elementIdx));
+    }
+}
+
+int Mesh::ElementGrid::getCellCoordinate(double value, int axis) const
+{
+    const double cellSize = (axis == 0) ? cellWidth : cellHeight;
+    return std::clamp(static_cast<int>(std::floor((value - boundingBox[axis]) / cellSize)), 0, size - 1);
+}
+
+void Mesh::buildElementGrid()
+{
+    const int numOfElements = getNumOfElements();
+    ElementGrid& grid = m_elementGrid;
+    grid.elementBoundingBoxes.resize(numOfElements);
+    grid.elementCellRanges.resize(numOfElements);
+    grid.boundingBox = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+    for (int elementIdx = 0; elementIdx < numOfElements; elementIdx++)
+    {
+        const Element& element = getElement(elementIdx);
+        ElementGrid::BoundingBox& box = grid.elementBoundingBoxes[elementIdx];
+        box = {INFINITY, INFINITY, -INFINITY, -INFINITY};
+        for (int i = 0; i < element.getNumOfNodes(); i++)
+        {
+            const Node node = element.getNode(i);
+            const double x = node(0).get_d();
+            const double y = node(1).get_d();
+            box = {std::min(box[0], x), std::min(box[1], y), std::max(box[2], x), std::max(box[3], y)};
+        }
+        grid.boundingBox = {std::min(grid.boundingBox[0], box[0]), std::min(grid.boundingBox[1], box[1]),
+                            std::max(grid.boundingBox[2], box[2]), std::max(grid.boundingBox[3], box[3])};
+    }
+    if (numOfElements == 0)
+    {
+        return;
+    }
+
+    const double width = grid.boundingBox[2] - grid.boundingBox[0];
+    const double height = grid.boundingBox[3] - grid.boundingBox[1];
+    grid.tolerance = 1e-9 * std::max(width, height);
+    grid.size = std::max(1, static_cast<int>(std::sqrt(numOfElements)));
+    grid.cellWidth = width / grid.size;
+    grid.cellHeight = height / grid.size;
+    grid.cells.resize(grid.size * grid.size);
+    for (int elementIdx = 0; elementIdx < numOfElements; elementIdx++)
+    {
+        const ElementGrid::BoundingBox& box = grid.elementBoundingBoxes[elementIdx];
+        ElementGrid::CellRange& range = grid.elementCellRanges[elementIdx];
+        range = {grid.getCellCoordinate(box[0] - grid.tolerance, 0),
+                 grid.getCellCoordinate(box[1] - grid.tolerance, 1),
+                 grid.getCellCoordinate(box[2] + grid.tolerance, 0),
+                 grid.getCellCoordinate(box[3] + grid.tolerance, 1)};
+        for (int iy = range[1]; iy <= range[3]; iy++)
+        {
+            for (int ix = range[0]; ix <= range[2]; ix++)
+            {
+                grid.cells[iy * grid.size + ix].push_back(elementIdx);
+            }
+        }
+    }
+}
+
 void Mesh::assignGlobalSideIndices()
 {
     std::map<std::pair<NodeIndex, NodeIndex>, SideIndex> sides;
@@ -126,30 +231,87 @@ void Mesh::updateAdjacentElements()
     }
 }
 
+/* Only elements with overlapping bounding boxes can intersect, so only pairs sharing a grid cell are checked */
 void Mesh::validateElements()
 {
-    for (int i = 0; i < getNumOfElements(); i++)
+    const ElementGrid& grid = m_elementGrid;
+    for (int iy = 0; iy < grid.size; iy++)
     {
-        const Element& element1 = getElement(i);
-        for (int j = i + 1; j < getNumOfElements(); j++)
+        for (int ix = 0; ix < grid.size; ix++)
         {
-            const Element& element2 = getElement(j);
-            assert(!areIntersecting(element1, element2) || isIntersectionOneNode(element1, element2) || isIntersectionOneSide(element1, element2));
+            const std::vector<ElementIndex>& cell = grid.cells[iy * grid.size + ix];
+            for (int i = 0; i < cell.size(); i++)
+            {
+                const ElementGrid::BoundingBox& box1 = grid.elementBoundingBoxes[cell[i]];
+                const ElementGrid::CellRange& range1 = grid.elementCellRanges[cell[i]];
+                for (int j = i + 1; j < cell.size(); j++)
+                {
+                    const ElementGrid::BoundingBox& box2 = grid.elementBoundingBoxes[cell[j]];
+                    const ElementGrid::CellRange& range2 = grid.elementCellRanges[cell[j]];
+                    /* Each pair is checked only in the first cell the two elements share */
+                    if (std::max(range1[0], range2[0]) != ix || std::max(range1[1], range2[1]) != iy)
+                    {
+                        continue;
+                    }
+                    if (box1[0] > box2[2] + grid.tolerance || box2[0] > box1[2] + grid.tolerance ||
+                        box1[1] > box2[3] + grid.tolerance || box2[1] > box1[3] + grid.tolerance)
+                    {
+                        continue;
+                    }
+                    const Element& element1 = getElement(cell[i]);
+                    const Element& element2 = getElement(cell[j]);
+                    assert(!areIntersecting(element1, element2) || isIntersectionOneNode(element1, element2) || isIntersectionOneSide(element1, element2));
+                }
+            }
         }
     }
 }
 
-Mesh::ElementIndex getIndexOfElementContainingPoint(const Mesh& mesh, const Vector2mpq& point)
+/* Greedy coloring in element order, each element gets the smallest color not used by its node neighbours */
+void Mesh::colorElements()
 {
-    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    std::vector<std::vector<ElementIndex>> elementsOfNode(m_numOfNodes);
+    for (int elementIdx = 0; elementIdx < getNumOfElements(); elementIdx++)
     {
-        if (isPointInsideElement(point, mesh.getElement(elementIdx)))
+        for (const NodeIndex nodeIdx : m_globalNodeIndices[elementIdx])
         {
-            return elementIdx;
+            elementsOfNode[nodeIdx].push_back(elementIdx);
         }
     }
-    assert(false && "Point is outside the mesh");
-    return -1;
+    std::vector<int> colorOfElement(getNumOfElements(), -1);
+    std::vector<ElementIndex> colorBlockedBy; // colorBlockedBy[c] == elementIdx if color c is used by a neighbour of elementIdx
+    for (int elementIdx = 0; elementIdx < getNumOfElements(); elementIdx++)
+    {
+        for (const NodeIndex nodeIdx : m_globalNodeIndices[elementIdx])
+        {
+            for (const ElementIndex neighbourIdx : elementsOfNode[nodeIdx])
+            {
+                if (colorOfElement[neighbourIdx] != -1)
+                {
+                    colorBlockedBy[colorOfElement[neighbourIdx]] = elementIdx;
+                }
+            }
+        }
+        int color = 0;
+        while (color < colorBlockedBy.size() && colorBlockedBy[color] == elementIdx)
+        {
+            color++;
+        }
+        if (color == m_elementColors.size())
+        {
+            m_elementColors.emplace_back();
+            colorBlockedBy.push_back(-1);
+        }
+        colorOfElement[elementIdx] = color;
+        m_elementColors[color].push_back(elementIdx);
+    }
+}
+
+Mesh::ElementIndex getIndexOfElementContainingPoint(const Mesh& mesh, const Vector2mpq& point)
+{
+    const std::optional<Mesh::ElementIndex> elementIdx = mesh.findElementContainingPoint(point);
+    assert(elementIdx.has_value() && "Point is outside the mesh");
+    return elementIdx.value();
 }
 
 const Element& getElementContainingPoint(const Mesh& mesh, const Vector2mpq& point)
@@ -231,13 +393,64 @@ std::pair<std::vector<Node>, std::vector<std::vector<Mesh::NodeIndex>>> parseMes
     return std::make_pair(std::move(nodes), std::move(elements));
 }
 
+Mesh createStructuredMesh(StructuredMeshType structuredMeshType, uint32_t nx, uint32_t ny, const Vector2mpq& lowerLeft, const Vector2mpq& upperRight)
+{
+    const auto nodesAndElements = generateStructuredMesh(structuredMeshType, nx, ny, lowerLeft, upperRight);
+    return Mesh(nodesAndElements.first, nodesAndElements.second);
+}
+
+std::pair<std::vector<Node>, std::vector<std::vector<Mesh::NodeIndex>>> generateStructuredMesh(StructuredMeshType structuredMeshType, uint32_t nx, uint32_t ny, const Vector2mpq& lowerLeft, const Vector2mpq& upperRight)
+{
+    assert(nx >= 1 && ny >= 1);
+    assert(lowerLeft(0) < upperRight(0) && lowerLeft(1) < upperRight(1));
+    std::vector<Node> nodes;
+    nodes.reserve((nx + 1) * (ny + 1));
+    const mpq_class dx = (upperRight(0) - lowerLeft(0)) / nx;
+    const mpq_class dy = (upperRight(1) - lowerLeft(1)) / ny;
+    for (int j = 0; j <= ny; j++)
+    {
+        const mpq_class y = (j == ny) ? upperRight(1) : mpq_class(lowerLeft(1) + j * dy);
+        for (int i = 0; i <= nx; i++)
+        {
+            const mpq_class x = (i == nx) ? upperRight(0) : mpq_class(lowerLeft(0) + i * dx);
+            nodes.push_back(Node(x, y));
+        }
+    }
+    std::vector<std::vector<Mesh::NodeIndex>> elements;
+    elements.reserve((structuredMeshType == StructuredMeshType_Parallelogram ? 1 : 2) * nx * ny);
+    for (int j = 0; j < ny; j++)
+    {
+        for (int i = 0; i < nx; i++)
+        {
+            /* c d
+             * a b */
+            const Mesh::NodeIndex a = j * (nx + 1) + i;
+            const Mesh::NodeIndex b = a + 1;
+            const Mesh::NodeIndex c = a + nx + 1;
+            const Mesh::NodeIndex d = c + 1;
+            const bool isParallelogram = (structuredMeshType == StructuredMeshType_Parallelogram) ||
+                                         (structuredMeshType == StructuredMeshType_Mixed && (i + j) % 2 == 0);
+            if (isParallelogram)
+            {
+                elements.push_back({a, b, d, c});
+            }
+            else
+            {
+                elements.push_back({a, b, c});
+                elements.push_back({b, d, c});
+            }
+        }
+    }
+    return std::make_pair(std::move(nodes), std::move(elements));
+}
+
 mpq_class calculateMeshArea(const Mesh& mesh)
 {
     mpq_class res = 0;
     for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
     {
         const Element& element = mesh.getElement(elementIdx);
-        const mpq_class detA = element.getReferenceElementMap().A.determinant();
+        const mpq_class& detA = mesh.getElementGeometry(elementIdx).detA;
         if (element.getElementType() == ElementType_Parallelogram)
         {
             res += 4 * detA;
@@ -1,20 +1,47 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <cstdint>
 #include <istream>
 #include <memory>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "fem/domain/Element.hpp"
+#include "fem/domain/ElementGeometry.hpp"
 #include "fem/domain/Node.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
+enum StructuredMeshType
+{
+    StructuredMeshType_Triangle,
+    StructuredMeshType_Parallelogram,
+    StructuredMeshType_Mixed
+};
+
+inline std::ostream& operator<<(std::ostream& out, StructuredMeshType structuredMeshType)
+{
+    if (structuredMeshType == StructuredMeshType_Triangle)
+    {
+        out << "triangle";
+    }
+    else if (structuredMeshType == StructuredMeshType_Parallelogram)
+    {
+        out << "parallelogram";
+    }
+    else
+    {
+        out << "mixed";
+    }
+    return out;
+}
+
 class Mesh
 {
 public:
@@ -34,21 +61,54 @@ public:
 
     const Element& getElement(ElementIndex elementIdx) const { assert(elementIdx < getNumOfElements()); return *(m_elements[elementIdx]); }
     std::optional<ElementIndex> getIndexOfAdjacentElement(ElementIndex elementIdx, SideIndex localSideIdx) const;
+    const ElementGeometry& getElementGeometry(ElementIndex elementIdx) const { assert(elementIdx < getNumOfElements()); return m_elementGeometries[elementIdx]; }
+    const AffineMap& getInverseReferenceElementMap(ElementIndex elementIdx) const { return getElementGeometry(elementIdx).Finv; }
+    bool isPointInsideElement(const Vector2mpq& point, ElementIndex elementIdx) const;
+    /* Lowest index of the elements containing the point */
+    std::optional<ElementIndex> findElementContainingPoint(const Vector2mpq& point) const;
+    /* Partition of the elements such that no two elements of the same color share a node */
+    const std::vector<std::vector<ElementIndex>>& getElementColors() const { return m_elementColors; }
 
     bool containsTriangle() const { return m_containsTriangle; }
     bool containsQuadrilateral() const { return m_containsQuadrilateral; }
 
+private:
+    /* Uniform grid of about one element per cell over the bounding box of the mesh */
+    struct ElementGrid
+    {
+        using BoundingBox = std::array<double, 4>; // {xmin, ymin, xmax, ymax}
+        using CellRange = std::array<int, 4>; // {ixmin, iymin, ixmax, iymax}
+
+        BoundingBox boundingBox;
+        double cellWidth;
+        double cellHeight;
+        /* Boxes are widened by the tolerance so that rounding to double never separates touching boxes */
+        double tolerance;
+        int size;
+        std::vector<BoundingBox> elementBoundingBoxes;
+        std::vector<CellRange> elementCellRanges;
+        std::vector<std::vector<ElementIndex>> cells; // elements overlapping each cell in ascending order
+
+        int getCellCoordinate(double value, int axis) const;
+    };
+
 private:
     void createElements(const std::vector<Node>& nodes, const std::vector<std::vector<NodeIndex>>& elements);
+    void computeElementGeometries();
+    void buildElementGrid();
     void assignGlobalSideIndices();
     void updateAdjacentElements();
     void validateElements();
+    void colorElements();
 
 private:
     std::vector<std::unique_ptr<Element>> m_elements;
+    std::vector<ElementGeometry> m_elementGeometries;
+    ElementGrid m_elementGrid;
     std::vector<std::vector<NodeIndex>> m_globalNodeIndices;
     std::vector<std::vector<SideIndex>> m_globalSideIndices;
     std::vector<std::vector<ElementIndex>> m_adjacentElements;
+    std::vector<std::vector<ElementIndex>> m_elementColors;
     uint32_t m_numOfNodes;
     uint32_t m_numOfSides;
     bool m_containsTriangle;
@@ -61,5 +121,11 @@ std::vector<std::pair<Mesh::ElementIndex, Mesh::SideIndex>> getMeshBoundary(cons
 Mesh createMeshFromFile(const std::string& filename);
 Mesh createMeshFromFile(std::istream& input);
 std::pair<std::vector<Node>, std::vector<std::vector<Mesh::NodeIndex>>> parseMeshFile(std::istream& input);
+/*
+ * nx x ny grid of rectangles over [lowerLeft, upperRight]. Triangle meshes split each rectangle into two triangles,
+ * mixed meshes alternate between a parallelogram and two triangles in a checkerboard pattern.
+ */
+Mesh createStructuredMesh(StructuredMeshType structuredMeshType, uint32_t nx, uint32_t ny, const Vector2mpq& lowerLeft, const Vector2mpq& upperRight);
+std::pair<std::vector<Node>, std::vector<std::vector<Mesh::NodeIndex>>> generateStructuredMesh(StructuredMeshType structuredMeshType, uint32_t nx, uint32_t ny, const Vector2mpq& lowerLeft, const Vector2mpq& upperRight);
 mpq_class calculateMeshArea(const Mesh& mesh);
 } // namespace fem
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <sstream>
 
 #include "fem/domain/Mesh.hpp"
@@ -131,6 +132,35 @@ TEST_F(MeshTestFixture, GetIndexOfAdjacentElement)
     EXPECT_EQ(mesh.getIndexOfAdjacentElement(6, 3).value(), 5);
 }
 
+TEST_F(MeshTestFixture, GetElementColors)
+{
+    const auto& colors = mesh.getElementColors();
+    std::vector<int> colorOfElement(mesh.getNumOfElements(), -1);
+    for (int color = 0; color < colors.size(); color++)
+    {
+        for (const Mesh::ElementIndex elementIdx : colors[color])
+        {
+            EXPECT_EQ(colorOfElement.at(elementIdx), -1);
+            colorOfElement.at(elementIdx) = color;
+        }
+    }
+    for (int elementIdx1 = 0; elementIdx1 < mesh.getNumOfElements(); elementIdx1++)
+    {
+        ASSERT_NE(colorOfElement[elementIdx1], -1);
+        for (int elementIdx2 = elementIdx1 + 1; elementIdx2 < mesh.getNumOfElements(); elementIdx2++)
+        {
+            if (colorOfElement[elementIdx1] == colorOfElement[elementIdx2])
+            {
+                for (const Mesh::NodeIndex nodeIdx : elements[elementIdx1])
+                {
+                    EXPECT_EQ(std::count(elements[elementIdx2].begin(), elements[elementIdx2].end(), nodeIdx), 0);
+                }
+            }
+        }
+    }
+    EXPECT_EQ(colors[0], (std::vector<Mesh::ElementIndex>{0, 3}));
+}
+
 TEST_F(MeshTestFixture, GetIndexOfElementContainingPoint)
 {
     EXPECT_EQ(getIndexOfElementContainingPoint(mesh, Vector2mpq(mpq_class("3/4"), 0)), 7);
@@ -138,6 +168,54 @@ TEST_F(MeshTestFixture, GetIndexOfElementContainingPoint)
     EXPECT_EQ(getIndexOfElementContainingPoint(mesh, Vector2mpq(mpq_class("1/2"), mpq_class("-1/2"))), 3);
 }
 
+TEST_F(MeshTestFixture, GetElementGeometry)
+{
+    for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+    {
+        const ElementGeometry& geometry = mesh.getElementGeometry(elementIdx);
+        const AffineMap F = mesh.getElement(elementIdx).getReferenceElementMap();
+        EXPECT_EQ(geometry.F, F);
+        EXPECT_EQ(geometry.Finv, F.inverse());
+        EXPECT_EQ(geometry.detA, F.A.determinant());
+        EXPECT_EQ(geometry.M, Matrix2mpq(F.A.inverse() * F.A.inverse().transpose()));
+        EXPECT_EQ(mesh.getInverseReferenceElementMap(elementIdx), geometry.Finv);
+    }
+    EXPECT_EQ(mesh.getElementGeometry(2).detA, mpq_class("1/4"));
+}
+
+TEST_F(MeshTestFixture, FindElementContainingPoint)
+{
+    /* Points on shared nodes and sides belong to the element with the lowest index */
+    EXPECT_EQ(mesh.findElementContainingPoint(Vector2mpq(0, 0)), 1);
+    EXPECT_EQ(mesh.findElementContainingPoint(Vector2mpq(mpq_class("1/2"), 0)), 3);
+    EXPECT_EQ(mesh.findElementContainingPoint(Vector2mpq(mpq_class("1/2"), -1)), 5);
+    EXPECT_EQ(mesh.findElementContainingPoint(Vector2mpq(1, mpq_class("1/2"))), 7);
+    EXPECT_FALSE(mesh.findElementContainingPoint(Vector2mpq(mpq_class("1/2"), mpq_class("1/2"))).has_value());
+    EXPECT_FALSE(mesh.findElementContainingPoint(Vector2mpq(2, 0)).has_value());
+}
+
+TEST(MeshTest, FindElementContainingPointMatchesLinearSearch)
+{
+    const Mesh mesh = createStructuredMesh(StructuredMeshType_Mixed, 5, 3, Vector2mpq(-1, 0), Vector2mpq(mpq_class("1/3"), 1));
+    for (int i = -2; i <= 22; i++)
+    {
+        for (int j = -2; j <= 14; j++)
+        {
+            const Vector2mpq point(mpq_class(i) / 15 * mpq_class(4, 3) - 1, mpq_class(j) / 12);
+            std::optional<Mesh::ElementIndex> expected;
+            for (int elementIdx = 0; elementIdx < mesh.getNumOfElements(); elementIdx++)
+            {
+                if (isPointInsideElement(point, mesh.getElement(elementIdx)))
+                {
+                    expected = elementIdx;
+                    break;
+                }
+            }
+            EXPECT_EQ(mesh.findElementContainingPoint(point), expected);
+        }
+    }
+}
+
 TEST_F(MeshTestFixture, GetMeshBoundary)
 {
     const std::vector<std::pair<Mesh::ElementIndex, Mesh::SideIndex>> expected = {
@@ -166,6 +244,45 @@ TEST(MeshTest, ParseMeshFile)
     EXPECT_EQ(nodesAndElements.second, (std::vector<std::vector<Mesh::NodeIndex>>{{0,1,2,3}, {2,4,3}}));
 }
 
+TEST(MeshTest, GenerateStructuredMesh)
+{
+    const Vector2mpq lowerLeft(-1, -1);
+    const Vector2mpq upperRight(1, 1);
+    const std::vector<Node> expectedNodes = {{-1, -1}, {0, -1}, {1, -1}, {-1, 0}, {0, 0}, {1, 0}, {-1, 1}, {0, 1}, {1, 1}};
+
+    auto nodesAndElements = generateStructuredMesh(StructuredMeshType_Triangle, 2, 2, lowerLeft, upperRight);
+    EXPECT_EQ(nodesAndElements.first, expectedNodes);
+    EXPECT_EQ(nodesAndElements.second, (std::vector<std::vector<Mesh::NodeIndex>>{
+        {0,1,3}, {1,4,3}, {1,2,4}, {2,5,4}, {3,4,6}, {4,7,6}, {4,5,7}, {5,8,7}}));
+
+    nodesAndElements = generateStructuredMesh(StructuredMeshType_Parallelogram, 2, 2, lowerLeft, upperRight);
+    EXPECT_EQ(nodesAndElements.first, expectedNodes);
+    EXPECT_EQ(nodesAndElements.second, (std::vector<std::vector<Mesh::NodeIndex>>{{0,1,4,3}, {1,2,5,4}, {3,4,7,6}, {4,5,8,7}}));
+
+    nodesAndElements = generateStructuredMesh(StructuredMeshType_Mixed, 2, 2, lowerLeft, upperRight);
+    EXPECT_EQ(nodesAndElements.first, expectedNodes);
+    EXPECT_EQ(nodesAndElements.second, (std::vector<std::vector<Mesh::NodeIndex>>{
+        {0,1,4,3}, {1,2,4}, {2,5,4}, {3,4,6}, {4,7,6}, {4,5,8,7}}));
+}
+
+TEST(MeshTest, CreateStructuredMesh)
+{
+    const Vector2mpq lowerLeft(mpq_class("-1/3"), 0);
+    const Vector2mpq upperRight(1, mpq_class("5/7"));
+    for (const StructuredMeshType structuredMeshType : {StructuredMeshType_Triangle, StructuredMeshType_Parallelogram, StructuredMeshType_Mixed})
+    {
+        const Mesh mesh = createStructuredMesh(structuredMeshType, 7, 5, lowerLeft, upperRight);
+        EXPECT_EQ(mesh.getNumOfNodes(), 8 * 6);
+        EXPECT_EQ(calculateMeshArea(mesh), mpq_class("4/3") * mpq_class("5/7"));
+        EXPECT_EQ(mesh.containsTriangle(), structuredMeshType != StructuredMeshType_Parallelogram);
+        EXPECT_EQ(mesh.containsQuadrilateral(), structuredMeshType != StructuredMeshType_Triangle);
+        EXPECT_EQ(getMeshBoundary(mesh).size(), 2 * (7 + 5));
+    }
+    EXPECT_EQ(createStructuredMesh(StructuredMeshType_Triangle, 7, 5, lowerLeft, upperRight).getNumOfElements(), 2 * 7 * 5);
+    EXPECT_EQ(createStructuredMesh(StructuredMeshType_Parallelogram, 7, 5, lowerLeft, upperRight).getNumOfElements(), 7 * 5);
+    EXPECT_EQ(createStructuredMesh(StructuredMeshType_Mixed, 7, 5, lowerLeft, upperRight).getNumOfElements(), 18 + 2 * 17);
+}
+
 TEST(MeshTest, NonConformingMeshAborts)
 {
     std::vector<Node> nodes;
@@ -2,33 +2,49 @@
 
 namespace fem
 {
-Vector2mpq AffineMap::operator()(const Vector2mpq& x) const
+template<typename Scalar>
+Eigen::Vector2<Scalar> BasicAffineMap<Scalar>::operator()(const Eigen::Vector2<Scalar>& x) const
 {
-    const Vector2mpq Ax = A*x;
+    const Eigen::Vector2<Scalar> Ax = A*x;
     return Ax + b;
 }
 
-AffineMap AffineMap::inverse() const
+template<typename Scalar>
+BasicAffineMap<Scalar> BasicAffineMap<Scalar>::inverse() const
 {
-    const Matrix2mpq Ainv = A.inverse();
-    return AffineMap(Ainv, -Ainv * b);
+    const Eigen::Matrix2<Scalar> Ainv = A.inverse();
+    return BasicAffineMap(Ainv, -Ainv * b);
 }
 
-AffineMap compose(const AffineMap& F, const AffineMap& G)
+template<typename Scalar>
+BasicAffineMap<Scalar> compose(const BasicAffineMap<Scalar>& F, const BasicAffineMap<Scalar>& G)
 {
-    const Matrix2mpq ANew = F.A * G.A;
-    Vector2mpq bNew = F.A * G.b;
+    const Eigen::Matrix2<Scalar> ANew = F.A * G.A;
+    Eigen::Vector2<Scalar> bNew = F.A * G.b;
     bNew += F.b;
-    return AffineMap(ANew, bNew);
+    return BasicAffineMap<Scalar>(ANew, bNew);
 }
 
-bool operator==(const AffineMap& lhs, const AffineMap& rhs)
+template<typename Scalar>
+bool operator==(const BasicAffineMap<Scalar>& lhs, const BasicAffineMap<Scalar>& rhs)
 {
     return (lhs.A == rhs.A) && (lhs.b == rhs.b);
 }
 
-bool operator!=(const AffineMap& lhs, const AffineMap& rhs)
+template<typename Scalar>
+bool operator!=(const BasicAffineMap<Scalar>& lhs, const BasicAffineMap<Scalar>& rhs)
 {
     return !(lhs == rhs);
 }
+
+#define INSTANTIATE_AFFINE_MAP(Scalar) \
+    template struct BasicAffineMap<Scalar>; \
+    template BasicAffineMap<Scalar> compose<Scalar>(const BasicAffineMap<Scalar>&, const BasicAffineMap<Scalar>&); \
+    template bool operator==<Scalar>(const BasicAffineMap<Scalar>&, const BasicAffineMap<Scalar>&); \
+    template bool operator!=<Scalar>(const BasicAffineMap<Scalar>&, const BasicAffineMap<Scalar>&);
+
+INSTANTIATE_AFFINE_MAP(mpq_class)
+INSTANTIATE_AFFINE_MAP(mpf_class)
+INSTANTIATE_AFFINE_MAP(double)
+INSTANTIATE_AFFINE_MAP(long double)
 } // namespace fem
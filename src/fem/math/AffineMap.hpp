@@ -1,19 +1,34 @@
 #pragma once
 
+#include "fem/multiprecision/ScalarConversion.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
-struct AffineMap
+template<typename Scalar>
+struct BasicAffineMap
 {
-    Matrix2mpq A;
-    Vector2mpq b;
+    Eigen::Matrix2<Scalar> A;
+    Eigen::Vector2<Scalar> b;
 
-    Vector2mpq operator()(const Vector2mpq& p) const;
-    AffineMap inverse() const;
+    Eigen::Vector2<Scalar> operator()(const Eigen::Vector2<Scalar>& p) const;
+    BasicAffineMap inverse() const;
 };
 
-AffineMap compose(const AffineMap& F, const AffineMap& G);
-bool operator==(const AffineMap& lhs, const AffineMap& rhs);
-bool operator!=(const AffineMap& lhs, const AffineMap& rhs);
+using AffineMap = BasicAffineMap<mpq_class>;
+
+template<typename Scalar>
+BasicAffineMap<Scalar> compose(const BasicAffineMap<Scalar>& F, const BasicAffineMap<Scalar>& G);
+template<typename Scalar>
+bool operator==(const BasicAffineMap<Scalar>& lhs, const BasicAffineMap<Scalar>& rhs);
+template<typename Scalar>
+bool operator!=(const BasicAffineMap<Scalar>& lhs, const BasicAffineMap<Scalar>& rhs);
+
+/* Rounds the coefficients of an exact map, see convertRational */
+template<typename Scalar>
+BasicAffineMap<Scalar> convertAffineMap(const AffineMap& F)
+{
+    const auto convert = [](const mpq_class& x) { return convertRational<Scalar>(x); };
+    return BasicAffineMap<Scalar>(F.A.unaryExpr(convert), F.b.unaryExpr(convert));
+}
 } // namespace fem
@@ -6,7 +6,10 @@
 
 namespace fem
 {
+template<typename Scalar>
+using BasicBivariateFunction = std::function<Scalar(const Eigen::Vector2<Scalar>&)>;
+
 using UnivariateFunction = std::function<mpq_class(const mpq_class&)>;
-using BivariateFunction = std::function<mpq_class(const Vector2mpq&)>;
+using BivariateFunction = BasicBivariateFunction<mpq_class>;
 using GradientFunction = std::function<Vector2mpq(const Vector2mpq&)>;
 } // namespace fem
@@ -1,5 +1,6 @@
 #include "fem/math/polynomial/Polynomial2D.hpp"
 
+#include <algorithm>
 #include <cassert>
 
 #include <boost/algorithm/string/trim.hpp>
@@ -17,42 +18,76 @@ void validatePolynomialString(const std::string& polynomialStr)
 }
 } // namespace
 
-Polynomial2D::Polynomial2D(const std::string& polynomialStr)
+template<typename Scalar>
+BasicPolynomial2D<Scalar>::BasicPolynomial2D(const std::string& polynomialStr)
+    : m_degreeOfX(0)
+    , m_degreeOfY(0)
+    , m_coefficients(1)
 {
     parsePolynomialString(polynomialStr);
 }
 
-Polynomial2D::Polynomial2D(const Monomial2D& monomial)
+template<typename Scalar>
+BasicPolynomial2D<Scalar>::BasicPolynomial2D(const Monomial2D& monomial)
+    : m_degreeOfX(0)
+    , m_degreeOfY(0)
+    , m_coefficients(1)
 {
     addMonomial(monomial);
 }
 
-Polynomial2D::Polynomial2D(const mpq_class& constant)
-    : Polynomial2D(Monomial2D(constant, 0, 0))
+template<typename Scalar>
+BasicPolynomial2D<Scalar>::BasicPolynomial2D(const Scalar& constant)
+    : m_degreeOfX(0)
+    , m_degreeOfY(0)
+    , m_coefficients(1, constant)
 {
 }
 
-Polynomial2D::Polynomial2D(int constant)
-    : Polynomial2D(mpq_class(constant))
+template<typename Scalar>
+BasicPolynomial2D<Scalar>::BasicPolynomial2D(int constant)
+    : BasicPolynomial2D(Scalar(constant))
 {
 }
 
-Polynomial2D::Polynomial2D()
-    : Polynomial2D(0)
+template<typename Scalar>
+BasicPolynomial2D<Scalar>::BasicPolynomial2D()
+    : BasicPolynomial2D(0)
 {
 }
 
-mpq_class Polynomial2D::operator()(const Vector2mpq& p) const
+template<typename Scalar>
+BasicPolynomial2D<Scalar>::BasicPolynomial2D(uint32_t degreeOfX, uint32_t degreeOfY, std::vector<Scalar> coefficients)
+    : m_degreeOfX(degreeOfX)
+    , m_degreeOfY(degreeOfY)
+    , m_coefficients(std::move(coefficients))
 {
-    mpq_class res = 0;
-    for (const auto& monomial : getMonomials())
+    assert(m_coefficients.size() == (degreeOfX + 1) * (degreeOfY + 1));
+    trim();
+}
+
+template<typename Scalar>
+Scalar BasicPolynomial2D<Scalar>::operator()(const Eigen::Vector2<Scalar>& p) const
+{
+    /* Horner's scheme in both variables */
+    Scalar res = 0;
+    Scalar rowValue;
+    for (int degreeOfX = m_degreeOfX; degreeOfX >= 0; degreeOfX--)
     {
-        res += monomial(p);
+        rowValue = 0;
+        for (int degreeOfY = m_degreeOfY; degreeOfY >= 0; degreeOfY--)
+        {
+            rowValue *= p(1);
+            rowValue += m_coefficients[getCoefficientIndex(degreeOfX, degreeOfY)];
+        }
+        res *= p(0);
+        res += rowValue;
     }
     return res;
 }
 
-Polynomial2D& Polynomial2D::operator+=(const Polynomial2D& rhs)
+template<typename Scalar>
+BasicPolynomial2D<Scalar>& BasicPolynomial2D<Scalar>::operator+=(const BasicPolynomial2D& rhs)
 {
     if (this != &rhs)
     {
@@ -60,12 +95,13 @@ Polynomial2D& Polynomial2D::operator+=(const Polynomial2D& rhs)
     }
     else
     {
-        doAddition(Polynomial2D(rhs));
+        doAddition(BasicPolynomial2D(rhs));
     }
     return *this;
 }
 
-Polynomial2D& Polynomial2D::operator-=(const Polynomial2D& rhs)
+template<typename Scalar>
+BasicPolynomial2D<Scalar>& BasicPolynomial2D<Scalar>::operator-=(const BasicPolynomial2D& rhs)
 {
     if (this != &rhs)
     {
@@ -73,18 +109,63 @@ Polynomial2D& Polynomial2D::operator-=(const Polynomial2D& rhs)
     }
     else
     {
-        doSubtraction(Polynomial2D(rhs));
+        doSubtraction(BasicPolynomial2D(rhs));
     }
     return *this;
 }
 
-Polynomial2D& Polynomial2D::operator*=(const Polynomial2D& rhs)
+template<typename Scalar>
+BasicPolynomial2D<Scalar>& BasicPolynomial2D<Scalar>::operator*=(const BasicPolynomial2D& rhs)
 {
     *this = *this * rhs;
     return *this;
 }
 
-void Polynomial2D::parsePolynomialString(const std::string& polynomialStr)
+template<typename Scalar>
+BasicPolynomial2D<Scalar> BasicPolynomial2D<Scalar>::multiply(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs)
+{
+    BasicPolynomial2D res;
+    res.resize(lhs.m_degreeOfX + rhs.m_degreeOfX, lhs.m_degreeOfY + rhs.m_degreeOfY);
+    Scalar product;
+    for (uint32_t i1 = 0; i1 <= lhs.m_degreeOfX; i1++)
+    {
+        for (uint32_t j1 = 0; j1 <= lhs.m_degreeOfY; j1++)
+        {
+            const Scalar& a = lhs.m_coefficients[lhs.getCoefficientIndex(i1, j1)];
+            if (isZero(a))
+            {
+                continue;
+            }
+            for (uint32_t i2 = 0; i2 <= rhs.m_degreeOfX; i2++)
+            {
+                for (uint32_t j2 = 0; j2 <= rhs.m_degreeOfY; j2++)
+                {
+                    const Scalar& b = rhs.m_coefficients[rhs.getCoefficientIndex(i2, j2)];
+                    if (isZero(b))
+                    {
+                        continue;
+                    }
+                    Scalar& c = res.m_coefficients[res.getCoefficientIndex(i1 + i2, j1 + j2)];
+                    if constexpr (std::is_same_v<Scalar, mpq_class>)
+                    {
+                        mpq_mul(product.get_mpq_t(), a.get_mpq_t(), b.get_mpq_t());
+                        mpq_add(c.get_mpq_t(), c.get_mpq_t(), product.get_mpq_t());
+                    }
+                    else
+                    {
+                        product = a * b;
+                        c += product;
+                    }
+                }
+            }
+        }
+    }
+    res.trim();
+    return res;
+}
+
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::parsePolynomialString(const std::string& polynomialStr)
 {
     validatePolynomialString(polynomialStr);
     for (const auto& monomialStr : getMonomialStrings(polynomialStr))
@@ -93,7 +174,8 @@ void Polynomial2D::parsePolynomialString(const std::string& polynomialStr)
     }
 }
 
-void Polynomial2D::parseMonomialString(const std::string& monomialStr)
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::parseMonomialString(const std::string& monomialStr)
 {
     const mpq_class coefficient = getCoefficientFromMonomialString(monomialStr);
     const uint32_t degreeOfX = getDegreeOfVariableFromMonomialString(monomialStr, 'x');
@@ -101,76 +183,105 @@ void Polynomial2D::parseMonomialString(const std::string& monomialStr)
     addMonomial(Monomial2D(coefficient, degreeOfX, degreeOfY));
 }
 
-void Polynomial2D::addMonomial(const Monomial2D& monomial)
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::addMonomial(const Monomial2D& monomial)
 {
-    const DegreePair key = std::make_pair(monomial.degreeOfX, monomial.degreeOfY);
-    auto [it, notUsed] = m_monomials.try_emplace(key, Monomial2D(mpq_class(0), monomial.degreeOfX, monomial.degreeOfY));
-    it->second.coefficient += monomial.coefficient;
-    if (mpq_sgn(it->second.coefficient.get_mpq_t()) == 0)
+    if (mpq_sgn(monomial.coefficient.get_mpq_t()) == 0)
     {
-        m_monomials.erase(key);
+        return;
     }
-}
-
-void Polynomial2D::doAddition(const Polynomial2D& rhs)
-{
-    for (const auto& monomial : rhs.getMonomials())
+    resize(std::max(m_degreeOfX, monomial.degreeOfX), std::max(m_degreeOfY, monomial.degreeOfY));
+    Scalar& coefficient = m_coefficients[getCoefficientIndex(monomial.degreeOfX, monomial.degreeOfY)];
+    if constexpr (std::is_same_v<Scalar, mpq_class>)
     {
-        addMonomial(monomial);
+        coefficient += monomial.coefficient;
     }
-}
-
-void Polynomial2D::doSubtraction(const Polynomial2D& rhs)
-{
-    for (const auto& monomial : rhs.getMonomials())
+    else
     {
-        addMonomial(-monomial);
+        coefficient += convertRational<Scalar>(monomial.coefficient);
     }
+    trim();
 }
 
-Polynomial2D operator+(const Polynomial2D& lhs, const Polynomial2D& rhs)
-{
-    Polynomial2D res = lhs;
-    res += rhs;
-    return res;
-}
-
-Polynomial2D operator-(const Polynomial2D& lhs, const Polynomial2D& rhs)
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::doAddition(const BasicPolynomial2D& rhs)
 {
-    Polynomial2D res = lhs;
-    res -= rhs;
-    return res;
-}
-
-Polynomial2D operator*(const Polynomial2D& lhs, const Polynomial2D& rhs)
-{
-    Polynomial2D res;
-    for (const auto& lhsMonomial : lhs.getMonomials())
+    resize(std::max(m_degreeOfX, rhs.m_degreeOfX), std::max(m_degreeOfY, rhs.m_degreeOfY));
+    for (uint32_t degreeOfX = 0; degreeOfX <= rhs.m_degreeOfX; degreeOfX++)
     {
-        for (const auto& rhsMonomial : rhs.getMonomials())
+        for (uint32_t degreeOfY = 0; degreeOfY <= rhs.m_degreeOfY; degreeOfY++)
         {
-            res.addMonomial(lhsMonomial * rhsMonomial);
+            m_coefficients[getCoefficientIndex(degreeOfX, degreeOfY)] += rhs.m_coefficients[rhs.getCoefficientIndex(degreeOfX, degreeOfY)];
         }
     }
-    return res;
+    trim();
 }
 
-Polynomial2D operator-(const Polynomial2D& op)
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::doSubtraction(const BasicPolynomial2D& rhs)
 {
-    return Polynomial2D(0) - op;
+    resize(std::max(m_degreeOfX, rhs.m_degreeOfX), std::max(m_degreeOfY, rhs.m_degreeOfY));
+    for (uint32_t degreeOfX = 0; degreeOfX <= rhs.m_degreeOfX; degreeOfX++)
+    {
+        for (uint32_t degreeOfY = 0; degreeOfY <= rhs.m_degreeOfY; degreeOfY++)
+        {
+            m_coefficients[getCoefficientIndex(degreeOfX, degreeOfY)] -= rhs.m_coefficients[rhs.getCoefficientIndex(degreeOfX, degreeOfY)];
+        }
+    }
+    trim();
 }
 
-bool operator==(const Polynomial2D& lhs, const Polynomial2D& rhs)
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::resize(uint32_t degreeOfX, uint32_t degreeOfY)
 {
-    return lhs.m_monomials == rhs.m_monomials;
+    if (degreeOfY == m_degreeOfY)
+    {
+        /* Rows are contiguous so growing or shrinking in x does not move any coefficients */
+        m_coefficients.resize((degreeOfX + 1) * (degreeOfY + 1));
+    }
+    else
+    {
+        using std::swap;
+        std::vector<Scalar> coefficients((degreeOfX + 1) * (degreeOfY + 1));
+        const uint32_t rows = std::min(degreeOfX, m_degreeOfX) + 1;
+        const uint32_t cols = std::min(degreeOfY, m_degreeOfY) + 1;
+        for (uint32_t i = 0; i < rows; i++)
+        {
+            for (uint32_t j = 0; j < cols; j++)
+            {
+                swap(coefficients[i * (degreeOfY + 1) + j], m_coefficients[getCoefficientIndex(i, j)]);
+            }
+        }
+        m_coefficients.swap(coefficients);
+    }
+    m_degreeOfX = degreeOfX;
+    m_degreeOfY = degreeOfY;
 }
 
-bool operator!=(const Polynomial2D& lhs, const Polynomial2D& rhs)
+template<typename Scalar>
+void BasicPolynomial2D<Scalar>::trim()
 {
-    return !(lhs == rhs);
+    uint32_t degreeOfX = 0;
+    uint32_t degreeOfY = 0;
+    for (uint32_t i = 0; i <= m_degreeOfX; i++)
+    {
+        for (uint32_t j = 0; j <= m_degreeOfY; j++)
+        {
+            if (!isZero(m_coefficients[getCoefficientIndex(i, j)]))
+            {
+                degreeOfX = i;
+                degreeOfY = std::max(degreeOfY, j);
+            }
+        }
+    }
+    if (degreeOfX != m_degreeOfX || degreeOfY != m_degreeOfY)
+    {
+        resize(degreeOfX, degreeOfY);
+    }
 }
 
-std::string toString(const Polynomial2D& polynomial)
+template<typename Scalar>
+std::string toString(const BasicPolynomial2D<Scalar>& polynomial)
 {
     auto polynomialIt = polynomial.getMonomials();
     std::vector<Monomial2D> monomials(polynomialIt.begin(), polynomialIt.end());
@@ -200,8 +311,19 @@ std::string toString(const Polynomial2D& polynomial)
     return res;
 }
 
-std::ostream& operator<<(std::ostream& out, const Polynomial2D& polynomial)
+template<typename Scalar>
+std::ostream& operator<<(std::ostream& out, const BasicPolynomial2D<Scalar>& polynomial)
 {
     return out << toString(polynomial);
 }
+
+#define INSTANTIATE_POLYNOMIAL_2D(Scalar) \
+    template class BasicPolynomial2D<Scalar>; \
+    template std::string toString<Scalar>(const BasicPolynomial2D<Scalar>&); \
+    template std::ostream& operator<< <Scalar>(std::ostream&, const BasicPolynomial2D<Scalar>&);
+
+INSTANTIATE_POLYNOMIAL_2D(mpq_class)
+INSTANTIATE_POLYNOMIAL_2D(mpf_class)
+INSTANTIATE_POLYNOMIAL_2D(double)
+INSTANTIATE_POLYNOMIAL_2D(long double)
 } // namespace fem
@@ -1,63 +1,129 @@
 #pragma once
 
+#include <cassert>
 #include <cstdint>
 #include <ostream>
 #include <ranges>
 #include <string>
-#include <unordered_map>
-#include <utility>
-
-#include <boost/functional/hash.hpp>
+#include <type_traits>
+#include <vector>
 
 #include "fem/math/polynomial/Monomial2D.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
-class Polynomial2D
+/* Exact for mpq_class. The other scalar types are for evaluating rounded copies of exact polynomials, see convertPolynomial. */
+template<typename Scalar>
+class BasicPolynomial2D
 {
 public:
-    explicit Polynomial2D(const std::string& polynomialStr);
-    Polynomial2D(const Monomial2D& monomial);
-    Polynomial2D(const mpq_class& constant);
-    Polynomial2D(int constant);
-    Polynomial2D();
+    explicit BasicPolynomial2D(const std::string& polynomialStr);
+    BasicPolynomial2D(const Monomial2D& monomial);
+    BasicPolynomial2D(const Scalar& constant);
+    BasicPolynomial2D(int constant);
+    BasicPolynomial2D();
+    /* Takes the coefficient array in the layout described at m_coefficients */
+    BasicPolynomial2D(uint32_t degreeOfX, uint32_t degreeOfY, std::vector<Scalar> coefficients);
 
     auto getMonomials() const
     {
-        return std::views::values(m_monomials);
+        return std::views::iota(uint32_t{0}, static_cast<uint32_t>(m_coefficients.size()))
+            | std::views::filter([this](uint32_t idx) { return !isZero(m_coefficients[idx]); })
+            | std::views::transform([this](uint32_t idx) { return Monomial2D(convertToRational(m_coefficients[idx]), idx / (m_degreeOfY + 1), idx % (m_degreeOfY + 1)); });
+    }
+
+    /* Upper bounds for the degrees of the variables, i.e. the dimensions of the coefficient array */
+    uint32_t getDegreeOfX() const { return m_degreeOfX; }
+    uint32_t getDegreeOfY() const { return m_degreeOfY; }
+    const Scalar& getCoefficient(uint32_t degreeOfX, uint32_t degreeOfY) const
+    {
+        assert(degreeOfX <= m_degreeOfX && degreeOfY <= m_degreeOfY);
+        return m_coefficients[getCoefficientIndex(degreeOfX, degreeOfY)];
     }
-    
-    mpq_class operator()(const Vector2mpq& p) const;
 
-    Polynomial2D& operator+=(const Polynomial2D& rhs);
-    Polynomial2D& operator-=(const Polynomial2D& rhs);
-    Polynomial2D& operator*=(const Polynomial2D& rhs);
+    Scalar operator()(const Eigen::Vector2<Scalar>& p) const;
 
-    friend Polynomial2D operator*(const Polynomial2D& lhs, const Polynomial2D& rhs);
-    friend bool operator==(const Polynomial2D& lhs, const Polynomial2D& rhs);
+    BasicPolynomial2D& operator+=(const BasicPolynomial2D& rhs);
+    BasicPolynomial2D& operator-=(const BasicPolynomial2D& rhs);
+    BasicPolynomial2D& operator*=(const BasicPolynomial2D& rhs);
 
-private:
-    using DegreePair = std::pair<uint32_t, uint32_t>;
-    using MonomialMap = std::unordered_map<DegreePair, Monomial2D, boost::hash<DegreePair>>;
+    friend BasicPolynomial2D operator+(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs)
+    {
+        BasicPolynomial2D res = lhs;
+        res += rhs;
+        return res;
+    }
+    friend BasicPolynomial2D operator-(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs)
+    {
+        BasicPolynomial2D res = lhs;
+        res -= rhs;
+        return res;
+    }
+    friend BasicPolynomial2D operator-(const BasicPolynomial2D& op) { return BasicPolynomial2D(0) - op; }
+    friend BasicPolynomial2D operator*(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs) { return multiply(lhs, rhs); }
+    friend bool operator==(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs)
+    {
+        return lhs.m_degreeOfX == rhs.m_degreeOfX && lhs.m_degreeOfY == rhs.m_degreeOfY && lhs.m_coefficients == rhs.m_coefficients;
+    }
+    friend bool operator!=(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs) { return !(lhs == rhs); }
 
 private:
+    static bool isZero(const Scalar& x)
+    {
+        if constexpr (std::is_same_v<Scalar, mpq_class>)
+        {
+            return mpq_sgn(x.get_mpq_t()) == 0;
+        }
+        else
+        {
+            return x == 0;
+        }
+    }
+
+    static BasicPolynomial2D multiply(const BasicPolynomial2D& lhs, const BasicPolynomial2D& rhs);
+
     void parsePolynomialString(const std::string& polynomialStr);
     void parseMonomialString(const std::string& monomialStr);
 
     void addMonomial(const Monomial2D& monomial);
 
-    void doAddition(const Polynomial2D& rhs);
-    void doSubtraction(const Polynomial2D& rhs);
+    void doAddition(const BasicPolynomial2D& rhs);
+    void doSubtraction(const BasicPolynomial2D& rhs);
+
+    uint32_t getCoefficientIndex(uint32_t degreeOfX, uint32_t degreeOfY) const { return degreeOfX * (m_degreeOfY + 1) + degreeOfY; }
+    void resize(uint32_t degreeOfX, uint32_t degreeOfY);
+    void trim();
 
 private:
-    MonomialMap m_monomials;
+    /* Dense (m_degreeOfX + 1) x (m_degreeOfY + 1) coefficient array in row-major order, i.e. the coefficient of x^i y^j
+     * is at index i * (m_degreeOfY + 1) + j. Trailing rows and columns of zeros are always trimmed away. */
+    uint32_t m_degreeOfX;
+    uint32_t m_degreeOfY;
+    std::vector<Scalar> m_coefficients;
 };
 
-Polynomial2D operator+(const Polynomial2D& lhs, const Polynomial2D& rhs);
-Polynomial2D operator-(const Polynomial2D& lhs, const Polynomial2D& rhs);
-Polynomial2D operator-(const Polynomial2D& op);
-bool operator!=(const Polynomial2D& lhs, const Polynomial2D& rhs);
-std::string toString(const Polynomial2D& polynomial);
-std::ostream& operator<<(std::ostream& out, const Polynomial2D& polynomial);
-} // namespace fem
\ No newline at end of file
+using Polynomial2D = BasicPolynomial2D<mpq_class>;
+
+/* Rounds the coefficients of an exact polynomial, see convertRational */
+template<typename Scalar>
+BasicPolynomial2D<Scalar> convertPolynomial(const Polynomial2D& polynomial)
+{
+    std::vector<Scalar> coefficients;
+    coefficients.reserve((polynomial.getDegreeOfX() + 1) * (polynomial.getDegreeOfY() + 1));
+    for (uint32_t degreeOfX = 0; degreeOfX <= polynomial.getDegreeOfX(); degreeOfX++)
+    {
+        for (uint32_t degreeOfY = 0; degreeOfY <= polynomial.getDegreeOfY(); degreeOfY++)
+        {
+            coefficients.push_back(convertRational<Scalar>(polynomial.getCoefficient(degreeOfX, degreeOfY)));
+        }
+    }
+    return BasicPolynomial2D<Scalar>(polynomial.getDegreeOfX(), polynomial.getDegreeOfY(), std::move(coefficients));
+}
+
+template<typename Scalar>
+std::string toString(const BasicPolynomial2D<Scalar>& polynomial);
+template<typename Scalar>
+std::ostream& operator<<(std::ostream& out, const BasicPolynomial2D<Scalar>& polynomial);
+} // namespace fem
@@ -36,91 +36,108 @@ Monomial2D diff(const Monomial2D& monomial, char var)
     }
     return Monomial2D(newCoefficient, newDegreeOfX, newDegreeOfY);
 }
+} // namespace
 
-mpq_class integrateOverReferenceTriangle(const Monomial2D& monomial)
+Polynomial1D diff(const Polynomial1D& polynomial)
 {
-    const uint32_t degreeOfX = monomial.degreeOfX;
-    const uint32_t degreeOfY = monomial.degreeOfY;
-    const mpz_class num = mpz_class::factorial(degreeOfX) * mpz_class::factorial(degreeOfY);
-    const mpz_class den = mpz_class::factorial(degreeOfX + degreeOfY + 2);
-    mpq_class res(num, den);
-    res.canonicalize();
-    res *= monomial.coefficient;
+    Polynomial1D res;
+    for (const auto& monomial : polynomial.getMonomials())
+    {
+        res += diff(monomial);
+    }
     return res;
 }
 
-mpq_class integrateOverReferenceQuadrilateral(const Monomial2D& monomial)
+Polynomial2D diff(const Polynomial2D& polynomial, char variable)
 {
-    const uint32_t degreeOfX = monomial.degreeOfX;
-    const uint32_t degreeOfY = monomial.degreeOfY;
-    if (degreeOfX % 2 != 0 || degreeOfY % 2 != 0)
-    {
-        return 0;
-    }
-    else
+    Polynomial2D res;
+    for (const auto& monomial : polynomial.getMonomials())
     {
-        mpq_class res(4, (degreeOfX + 1) * (degreeOfY + 1));
-        res.canonicalize();
-        res *= monomial.coefficient;
-        return res;
+        res += diff(monomial, variable);
     }
+    return res;
 }
 
-mpq_class integrateOverReferenceTriangle(const Polynomial2D& polynomial)
+mpq_class integrateOverReferenceInterval(const Polynomial1D& polynomial)
 {
     mpq_class res = 0;
     for (const auto& monomial : polynomial.getMonomials())
     {
-        res += integrateOverReferenceTriangle(monomial);
+        if (monomial.degree % 2 == 0)
+        {
+            res += 2 * monomial.coefficient / (monomial.degree + 1);
+        }
     }
     return res;
 }
 
-mpq_class integrateOverReferenceQuadrilateral(const Polynomial2D& polynomial)
+mpq_class integrateOverReferenceElement(const Polynomial2D& polynomial, const ReferenceMomentTable& moments)
 {
     mpq_class res = 0;
-    for (const auto& monomial : polynomial.getMonomials())
+    mpq_class product;
+    for (uint32_t i = 0; i <= polynomial.getDegreeOfX(); i++)
     {
-        res += integrateOverReferenceQuadrilateral(monomial);
+        for (uint32_t j = 0; j <= polynomial.getDegreeOfY(); j++)
+        {
+            const mpq_class& a = polynomial.getCoefficient(i, j);
+            if (mpq_sgn(a.get_mpq_t()) == 0)
+            {
+                continue;
+            }
+            mpq_mul(product.get_mpq_t(), a.get_mpq_t(), moments.getMoment(i, j).get_mpq_t());
+            mpq_add(res.get_mpq_t(), res.get_mpq_t(), product.get_mpq_t());
+        }
     }
     return res;
 }
-} // namespace
 
-Polynomial1D diff(const Polynomial1D& polynomial)
+mpq_class integrateOverReferenceElement(const Polynomial2D& polynomial, ElementType elementType)
 {
-    Polynomial1D res;
-    for (const auto& monomial : polynomial.getMonomials())
-    {
-        res += diff(monomial);
-    }
-    return res;
+    const ReferenceMomentTable moments(elementType, std::max(polynomial.getDegreeOfX(), polynomial.getDegreeOfY()));
+    return integrateOverReferenceElement(polynomial, moments);
 }
 
-Polynomial2D diff(const Polynomial2D& polynomial, char variable)
+mpq_class integrateProductOverReferenceElement(const Polynomial2D& lhs, const Polynomial2D& rhs, const ReferenceMomentTable& moments)
 {
-    Polynomial2D res;
-    for (const auto& monomial : polynomial.getMonomials())
+    /* Odd moments vanish over the reference quadrilateral so only every other monomial of rhs needs to be visited */
+    const uint32_t step = (moments.getElementType() == ElementType_Parallelogram) ? 2 : 1;
+    mpq_class res = 0;
+    mpq_class innerSum;
+    mpq_class product;
+    for (uint32_t i1 = 0; i1 <= lhs.getDegreeOfX(); i1++)
     {
-        res += diff(monomial, variable);
+        for (uint32_t j1 = 0; j1 <= lhs.getDegreeOfY(); j1++)
+        {
+            const mpq_class& a = lhs.getCoefficient(i1, j1);
+            if (mpq_sgn(a.get_mpq_t()) == 0)
+            {
+                continue;
+            }
+            innerSum = 0;
+            for (uint32_t i2 = (step == 2) ? i1 % 2 : 0; i2 <= rhs.getDegreeOfX(); i2 += step)
+            {
+                for (uint32_t j2 = (step == 2) ? j1 % 2 : 0; j2 <= rhs.getDegreeOfY(); j2 += step)
+                {
+                    const mpq_class& b = rhs.getCoefficient(i2, j2);
+                    if (mpq_sgn(b.get_mpq_t()) == 0)
+                    {
+                        continue;
+                    }
+                    mpq_mul(product.get_mpq_t(), b.get_mpq_t(), moments.getMoment(i1 + i2, j1 + j2).get_mpq_t());
+                    mpq_add(innerSum.get_mpq_t(), innerSum.get_mpq_t(), product.get_mpq_t());
+                }
+            }
+            mpq_mul(product.get_mpq_t(), a.get_mpq_t(), innerSum.get_mpq_t());
+            mpq_add(res.get_mpq_t(), res.get_mpq_t(), product.get_mpq_t());
+        }
     }
     return res;
 }
 
-mpq_class integrateOverReferenceElement(const Polynomial2D& polynomial, ElementType elementType)
+mpq_class integrateProductOverReferenceElement(const Polynomial2D& lhs, const Polynomial2D& rhs, ElementType elementType)
 {
-    if (elementType == ElementType_Triangle)
-    {
-        return integrateOverReferenceTriangle(polynomial);
-    }
-    else if (elementType == ElementType_Parallelogram)
-    {
-        return integrateOverReferenceQuadrilateral(polynomial);
-    }
-    else
-    {
-        assert(false);
-        return 0;
-    }
+    const uint32_t maxDegree = std::max(lhs.getDegreeOfX() + rhs.getDegreeOfX(), lhs.getDegreeOfY() + rhs.getDegreeOfY());
+    const ReferenceMomentTable moments(elementType, maxDegree);
+    return integrateProductOverReferenceElement(lhs, rhs, moments);
 }
 } // namespace fem
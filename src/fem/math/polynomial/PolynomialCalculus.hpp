@@ -3,10 +3,18 @@
 #include "fem/domain/Element.hpp"
 #include "fem/math/polynomial/Polynomial1D.hpp"
 #include "fem/math/polynomial/Polynomial2D.hpp"
+#include "fem/math/polynomial/ReferenceMomentTable.hpp"
 
 namespace fem
 {
 Polynomial1D diff(const Polynomial1D& polynomial);
 Polynomial2D diff(const Polynomial2D& polynomial, char variable);
+/* Integral over [-1, 1] */
+mpq_class integrateOverReferenceInterval(const Polynomial1D& polynomial);
 mpq_class integrateOverReferenceElement(const Polynomial2D& polynomial, ElementType elementType);
+mpq_class integrateOverReferenceElement(const Polynomial2D& polynomial, const ReferenceMomentTable& moments);
+
+/* Same as integrateOverReferenceElement(lhs * rhs, ...) but without forming the product polynomial */
+mpq_class integrateProductOverReferenceElement(const Polynomial2D& lhs, const Polynomial2D& rhs, ElementType elementType);
+mpq_class integrateProductOverReferenceElement(const Polynomial2D& lhs, const Polynomial2D& rhs, const ReferenceMomentTable& moments);
 } // namespace fem
@@ -0,0 +1,62 @@
+#include "fem/math/polynomial/ReferenceMomentTable.hpp"
+
+namespace fem
+{
+namespace
+{
+mpq_class makeRatio(uint32_t num, uint32_t den)
+{
+    mpq_class res(num, den);
+    res.canonicalize();
+    return res;
+}
+} // namespace
+
+ReferenceMomentTable::ReferenceMomentTable(ElementType elementType, uint32_t maxDegree)
+    : m_elementType(elementType)
+    , m_maxDegree(maxDegree)
+    , m_moments((maxDegree + 1) * (maxDegree + 1))
+{
+    assert(elementType == ElementType_Triangle || elementType == ElementType_Parallelogram);
+    if (elementType == ElementType_Triangle)
+    {
+        computeTriangleMoments();
+    }
+    else
+    {
+        computeQuadrilateralMoments();
+    }
+}
+
+/* Integral of x^i y^j over the reference triangle is i! j! / (i+j+2)!.
+ * The factorial ratios are built up incrementally from the neighbouring moments. */
+void ReferenceMomentTable::computeTriangleMoments()
+{
+    const uint32_t cols = m_maxDegree + 1;
+    m_moments[0] = mpq_class(1, 2);
+    for (uint32_t i = 0; i <= m_maxDegree; i++)
+    {
+        if (i > 0)
+        {
+            m_moments[i * cols] = m_moments[(i - 1) * cols] * makeRatio(i, i + 2);
+        }
+        for (uint32_t j = 1; j <= m_maxDegree; j++)
+        {
+            m_moments[i * cols + j] = m_moments[i * cols + j - 1] * makeRatio(j, i + j + 2);
+        }
+    }
+}
+
+/* Integral of x^i y^j over the reference quadrilateral [-1,1]^2 is 4 / ((i+1)(j+1)) if i and j are even and 0 otherwise */
+void ReferenceMomentTable::computeQuadrilateralMoments()
+{
+    const uint32_t cols = m_maxDegree + 1;
+    for (uint32_t i = 0; i <= m_maxDegree; i += 2)
+    {
+        for (uint32_t j = 0; j <= m_maxDegree; j += 2)
+        {
+            m_moments[i * cols + j] = makeRatio(4, (i + 1) * (j + 1));
+        }
+    }
+}
+} // namespace fem
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "fem/domain/Element.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/* Integrals of the monomials x^i y^j, 0 <= i,j <= maxDegree, over a reference element */
+class ReferenceMomentTable
+{
+public:
+    ReferenceMomentTable() = default;
+    ReferenceMomentTable(ElementType elementType, uint32_t maxDegree);
+
+    ElementType getElementType() const { return m_elementType; }
+    uint32_t getMaxDegree() const { return m_maxDegree; }
+
+    const mpq_class& getMoment(uint32_t degreeOfX, uint32_t degreeOfY) const
+    {
+        assert(degreeOfX <= m_maxDegree && degreeOfY <= m_maxDegree);
+        assert(!m_moments.empty());
+        return m_moments[degreeOfX * (m_maxDegree + 1) + degreeOfY];
+    }
+
+private:
+    void computeTriangleMoments();
+    void computeQuadrilateralMoments();
+
+private:
+    ElementType m_elementType = ElementType_Triangle;
+    uint32_t m_maxDegree = 0;
+    std::vector<mpq_class> m_moments;
+};
+} // namespace fem
@@ -60,4 +60,37 @@ TEST(Polynomial2DTest, Evaluation)
     EXPECT_EQ(Polynomial2D("x^2+2xy+y^2")({mpq_class("-4/3"), mpq_class("0")}), mpq_class("16/9"));
     EXPECT_EQ(Polynomial2D("  4 + 0 + x")({mpq_class(-4), mpq_class("1/5")}), mpq_class(0));
 }
+
+TEST(Polynomial2DTest, Coefficients)
+{
+    const Polynomial2D p("4/7x^3y - 8/3y^2 + 1");
+    EXPECT_EQ(p.getDegreeOfX(), 3);
+    EXPECT_EQ(p.getDegreeOfY(), 2);
+    EXPECT_EQ(p.getCoefficient(3, 1), mpq_class("4/7"));
+    EXPECT_EQ(p.getCoefficient(0, 2), mpq_class("-8/3"));
+    EXPECT_EQ(p.getCoefficient(0, 0), mpq_class(1));
+    EXPECT_EQ(p.getCoefficient(3, 2), mpq_class(0));
+    EXPECT_EQ(std::ranges::distance(p.getMonomials()), 3);
+
+    const Polynomial2D q = p - Polynomial2D("4/7x^3y - 8/3y^2");
+    EXPECT_EQ(q.getDegreeOfX(), 0);
+    EXPECT_EQ(q.getDegreeOfY(), 0);
+    EXPECT_EQ(q, Polynomial2D(1));
+    EXPECT_EQ(std::ranges::distance(Polynomial2D(0).getMonomials()), 0);
+}
+
+TEST(Polynomial2DTest, Conversion)
+{
+    const Polynomial2D p("4/7x^3y - 8/3y^2 + 1");
+    const BasicPolynomial2D<double> q = convertPolynomial<double>(p);
+    EXPECT_EQ(q.getDegreeOfX(), 3);
+    EXPECT_EQ(q.getDegreeOfY(), 2);
+    EXPECT_EQ(q.getCoefficient(3, 1), 4.0/7);
+    EXPECT_EQ(q.getCoefficient(0, 2), -8.0/3);
+    EXPECT_NEAR(q({0.5, -0.25}), p({mpq_class(1)/2, mpq_class(-1)/4}).get_d(), 1e-15);
+    const BasicPolynomial2D<double> r = convertPolynomial<double>(Polynomial2D("1/2x + 3/4y"));
+    EXPECT_EQ(r * r - 1, convertPolynomial<double>(Polynomial2D("1/4x^2 + 3/4xy + 9/16y^2 - 1")));
+    EXPECT_EQ(toString(convertPolynomial<double>(Polynomial2D("x^2y - 1/2"))), "x^2y-1/2");
+}
+
 } // namespace fem::ut
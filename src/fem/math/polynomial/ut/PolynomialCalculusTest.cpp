@@ -13,6 +13,15 @@ TEST(CalculusTest, Differentiation)
     EXPECT_EQ(diff(Polynomial2D("9/2xy^2+3/2y^2-x-1"), 'y'), Polynomial2D("9xy+3y"));
 }
 
+TEST(CalculusTest, IntegratePolynomialOverReferenceInterval)
+{
+    EXPECT_EQ(integrateOverReferenceInterval(Polynomial1D(0)), mpq_class(0));
+    EXPECT_EQ(integrateOverReferenceInterval(Polynomial1D(1)), mpq_class(2));
+    EXPECT_EQ(integrateOverReferenceInterval(Polynomial1D("3/2t^3-3/2t")), mpq_class(0));
+    EXPECT_EQ(integrateOverReferenceInterval(Polynomial1D("-1/4t^2+1/4t-1")), mpq_class("-13/6"));
+    EXPECT_EQ(integrateOverReferenceInterval(Polynomial1D("5t^4+t")), mpq_class(2));
+}
+
 TEST(CalculusTest, IntegratePolynomialOverReferenceElements)
 {
     EXPECT_EQ(integrateOverReferenceElement(Polynomial2D("-1/4x^2+1/4x-1"), ElementType_Parallelogram), mpq_class("-13/3"));
@@ -25,4 +34,21 @@ TEST(CalculusTest, IntegratePolynomialOverReferenceElements)
     EXPECT_EQ(integrateOverReferenceElement(Polynomial2D(0), ElementType_Triangle), mpq_class(0));
     EXPECT_EQ(integrateOverReferenceElement(Polynomial2D(1), ElementType_Triangle), mpq_class("1/2"));
 }
+
+TEST(CalculusTest, IntegrateProductOverReferenceElements)
+{
+    const Polynomial2D p1("9/2xy^2+3/2y^2-x-1");
+    const Polynomial2D p2("y^4+4xy^3+3y^3+6x^2y^2+9xy^2+2y^2-2x^2-2xy-3x-y-1");
+    const Polynomial2D p3("3/2y^3-3/2y");
+    for (const ElementType elementType : {ElementType_Triangle, ElementType_Parallelogram})
+    {
+        EXPECT_EQ(integrateProductOverReferenceElement(p1, p2, elementType), integrateOverReferenceElement(p1 * p2, elementType));
+        EXPECT_EQ(integrateProductOverReferenceElement(p2, p3, elementType), integrateOverReferenceElement(p2 * p3, elementType));
+        EXPECT_EQ(integrateProductOverReferenceElement(p3, p3, elementType), integrateOverReferenceElement(p3 * p3, elementType));
+        EXPECT_EQ(integrateProductOverReferenceElement(p1, Polynomial2D(0), elementType), mpq_class(0));
+        EXPECT_EQ(integrateProductOverReferenceElement(Polynomial2D(1), Polynomial2D(1), elementType), integrateOverReferenceElement(Polynomial2D(1), elementType));
+    }
+    EXPECT_EQ(integrateProductOverReferenceElement(Polynomial2D("x"), Polynomial2D("x"), ElementType_Parallelogram), mpq_class("4/3"));
+    EXPECT_EQ(integrateProductOverReferenceElement(Polynomial2D("x"), Polynomial2D("y"), ElementType_Triangle), mpq_class("1/24"));
+}
 } // namespace fem::ut
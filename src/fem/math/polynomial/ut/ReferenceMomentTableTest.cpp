@@ -0,0 +1,33 @@
+#include <gtest/gtest.h>
+
+#include "fem/math/polynomial/ReferenceMomentTable.hpp"
+
+namespace fem::ut
+{
+TEST(ReferenceMomentTableTest, TriangleMoments)
+{
+    const ReferenceMomentTable moments(ElementType_Triangle, 8);
+    EXPECT_EQ(moments.getElementType(), ElementType_Triangle);
+    EXPECT_EQ(moments.getMaxDegree(), 8);
+    for (uint32_t i = 0; i <= 8; i++)
+    {
+        for (uint32_t j = 0; j <= 8; j++)
+        {
+            mpq_class expected(mpz_class::factorial(i) * mpz_class::factorial(j), mpz_class::factorial(i + j + 2));
+            expected.canonicalize();
+            EXPECT_EQ(moments.getMoment(i, j), expected);
+        }
+    }
+}
+
+TEST(ReferenceMomentTableTest, QuadrilateralMoments)
+{
+    const ReferenceMomentTable moments(ElementType_Parallelogram, 5);
+    EXPECT_EQ(moments.getMoment(0, 0), mpq_class(4));
+    EXPECT_EQ(moments.getMoment(2, 0), mpq_class("4/3"));
+    EXPECT_EQ(moments.getMoment(2, 4), mpq_class("4/15"));
+    EXPECT_EQ(moments.getMoment(1, 0), mpq_class(0));
+    EXPECT_EQ(moments.getMoment(4, 5), mpq_class(0));
+    EXPECT_EQ(moments.getMoment(3, 3), mpq_class(0));
+}
+} // namespace fem::ut
@@ -4,9 +4,12 @@
 
 #include <gsl/gsl_integration.h>
 
+#include "fem/multiprecision/ScalarConversion.hpp"
+
 namespace fem
 {
-GaussLegendreTable1D::GaussLegendreTable1D(uint32_t n)
+template<typename Scalar>
+BasicGaussLegendreTable1D<Scalar>::BasicGaussLegendreTable1D(uint32_t n)
 {
     assert(n > 0);
     gsl_integration_glfixed_table* t = gsl_integration_glfixed_table_alloc(n);
@@ -14,9 +17,14 @@ GaussLegendreTable1D::GaussLegendreTable1D(uint32_t n)
     for (int i = 0; i < n; i++)
     {
         gsl_integration_glfixed_point(-1, 1, i, &x, &w, t);
-        m_weights.push_back(mpq_class(w));
-        m_abscissas.push_back(mpq_class(x));
+        m_weights.push_back(convertRational<Scalar>(mpq_class(w)));
+        m_abscissas.push_back(convertRational<Scalar>(mpq_class(x)));
     }
     gsl_integration_glfixed_table_free(t);
 }
+
+template class BasicGaussLegendreTable1D<mpq_class>;
+template class BasicGaussLegendreTable1D<mpf_class>;
+template class BasicGaussLegendreTable1D<double>;
+template class BasicGaussLegendreTable1D<long double>;
 } // namespace fem
@@ -7,18 +7,25 @@
 
 namespace fem
 {
-class GaussLegendreTable1D
+/* The nodes and weights come from GSL in double precision */
+template<typename Scalar>
+class BasicGaussLegendreTable1D
 {
 public:
-    explicit GaussLegendreTable1D(uint32_t n);
+    explicit BasicGaussLegendreTable1D(uint32_t n);
 
     const auto& getWeights() const { return m_weights; }
     const auto& getAbscissas() const { return m_abscissas; }
 
 private:
-    std::vector<mpq_class> m_weights;
-    std::vector<mpq_class> m_abscissas;
+    std::vector<Scalar> m_weights;
+    std::vector<Scalar> m_abscissas;
 };
 
-inline const GaussLegendreTable1D defaultGLTable1D{100};
+using GaussLegendreTable1D = BasicGaussLegendreTable1D<mpq_class>;
+
+/* Number of Gauss-Legendre nodes per dimension of the default tables */
+inline constexpr uint32_t defaultGLTableSize = 100;
+
+inline const GaussLegendreTable1D defaultGLTable1D{defaultGLTableSize};
 } // namespace fem
@@ -1,10 +1,11 @@
 #include "fem/math/quadrature/GaussLegendreTableQuadrilateral.hpp"
 
-#include "fem/math/quadrature/GaussLegendreTable1D.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
-GaussLegendreTableQuadrilateral::GaussLegendreTableQuadrilateral(uint32_t n)
+template<typename Scalar>
+BasicGaussLegendreTableQuadrilateral<Scalar>::BasicGaussLegendreTableQuadrilateral(uint32_t n)
 {
     const GaussLegendreTable1D t(n);
     for (int i = 0; i < n; i++)
@@ -15,9 +16,14 @@ GaussLegendreTableQuadrilateral::GaussLegendreTableQuadrilateral(uint32_t n)
         {
             const mpq_class& wj = t.getWeights().at(j);
             const mpq_class& xj = t.getAbscissas().at(j);
-            m_weights.push_back(wi * wj);
-            m_abscissas.push_back(Vector2mpq{xi, xj});
+            m_weights.push_back(convertRational<Scalar>(wi * wj));
+            m_abscissas.push_back(Eigen::Vector2<Scalar>{convertRational<Scalar>(xi), convertRational<Scalar>(xj)});
         }
     }
 }
+
+template class BasicGaussLegendreTableQuadrilateral<mpq_class>;
+template class BasicGaussLegendreTableQuadrilateral<mpf_class>;
+template class BasicGaussLegendreTableQuadrilateral<double>;
+template class BasicGaussLegendreTableQuadrilateral<long double>;
 } // namespace fem
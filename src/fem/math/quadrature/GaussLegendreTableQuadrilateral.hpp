@@ -1,24 +1,44 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
+#include "fem/math/quadrature/GaussLegendreTable1D.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
-class GaussLegendreTableQuadrilateral
+/* The table is computed in mpq_class and rounded to the other scalar types */
+template<typename Scalar>
+class BasicGaussLegendreTableQuadrilateral
 {
 public:
-    explicit GaussLegendreTableQuadrilateral(uint32_t n);
+    explicit BasicGaussLegendreTableQuadrilateral(uint32_t n);
 
     const auto& getWeights() const { return m_weights; }
     const auto& getAbscissas() const { return m_abscissas; }
 
 private:
-    std::vector<mpq_class> m_weights;
-    std::vector<Vector2mpq> m_abscissas;
+    std::vector<Scalar> m_weights;
+    std::vector<Eigen::Vector2<Scalar>> m_abscissas;
 };
 
-inline const GaussLegendreTableQuadrilateral defaultGLTableQuad{100};
+using GaussLegendreTableQuadrilateral = BasicGaussLegendreTableQuadrilateral<mpq_class>;
+
+inline const GaussLegendreTableQuadrilateral defaultGLTableQuad{defaultGLTableSize};
+
+template<typename Scalar>
+const BasicGaussLegendreTableQuadrilateral<Scalar>& getDefaultGLTableQuad()
+{
+    if constexpr (std::is_same_v<Scalar, mpq_class>)
+    {
+        return defaultGLTableQuad;
+    }
+    else
+    {
+        static const BasicGaussLegendreTableQuadrilateral<Scalar> table{defaultGLTableSize};
+        return table;
+    }
+}
 } // namespace fem
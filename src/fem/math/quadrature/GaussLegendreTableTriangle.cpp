@@ -1,10 +1,18 @@
 #include "fem/math/quadrature/GaussLegendreTableTriangle.hpp"
 
-#include "fem/math/quadrature/GaussLegendreTable1D.hpp"
+#include "fem/multiprecision/ScalarConversion.hpp"
 
 namespace fem
 {
-GaussLegendreTableTriangleQuadMapped::GaussLegendreTableTriangleQuadMapped(uint32_t n)
+template<typename Scalar>
+void BasicGaussLegendreTableTriangle<Scalar>::addPoint(const mpq_class& weight, const mpq_class& u, const mpq_class& v)
+{
+    m_weights.push_back(convertRational<Scalar>(weight));
+    m_abscissas.push_back(Eigen::Vector2<Scalar>{convertRational<Scalar>(u), convertRational<Scalar>(v)});
+}
+
+template<typename Scalar>
+BasicGaussLegendreTableTriangleQuadMapped<Scalar>::BasicGaussLegendreTableTriangleQuadMapped(uint32_t n)
 {
     const GaussLegendreTable1D t(n);
     for (int i = 0; i < n; i++)
@@ -18,13 +26,13 @@ GaussLegendreTableTriangleQuadMapped::GaussLegendreTableTriangleQuadMapped(uint3
             const mpq_class& xj = t.getAbscissas().at(j);
             const mpq_class v = (1 - xi) * (1 + xj) / 4;
             const mpq_class w = (1 - xi) * wi * wj / 8;
-            m_weights.push_back(w);
-            m_abscissas.push_back(Vector2mpq{u, v});
+            this->addPoint(w, u, v);
         }
     }
 }
 
-GaussLegendreTableTriangleCrowdingFree::GaussLegendreTableTriangleCrowdingFree(uint32_t n)
+template<typename Scalar>
+BasicGaussLegendreTableTriangleCrowdingFree<Scalar>::BasicGaussLegendreTableTriangleCrowdingFree(uint32_t n)
 {
     const GaussLegendreTable1D t1(n);
     for (int i = 0; i < n; i++)
@@ -39,9 +47,18 @@ GaussLegendreTableTriangleCrowdingFree::GaussLegendreTableTriangleCrowdingFree(u
             const mpq_class& xj = t2.getAbscissas().at(j);
             const mpq_class v = (1 - xi) * (1 + xj) / 4;
             const mpq_class w = (1 - xi) * wi * wj / 8;
-            m_weights.push_back(w);
-            m_abscissas.push_back(Vector2mpq{u, v});
+            this->addPoint(w, u, v);
         }
     }
 }
+
+#define INSTANTIATE_GAUSS_LEGENDRE_TABLES_TRIANGLE(Scalar) \
+    template class BasicGaussLegendreTableTriangle<Scalar>; \
+    template class BasicGaussLegendreTableTriangleQuadMapped<Scalar>; \
+    template class BasicGaussLegendreTableTriangleCrowdingFree<Scalar>;
+
+INSTANTIATE_GAUSS_LEGENDRE_TABLES_TRIANGLE(mpq_class)
+INSTANTIATE_GAUSS_LEGENDRE_TABLES_TRIANGLE(mpf_class)
+INSTANTIATE_GAUSS_LEGENDRE_TABLES_TRIANGLE(double)
+INSTANTIATE_GAUSS_LEGENDRE_TABLES_TRIANGLE(long double)
 } // namespace fem
@@ -1,40 +1,67 @@
 #pragma once
 
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
+#include "fem/math/quadrature/GaussLegendreTable1D.hpp"
 #include "fem/multiprecision/Types.hpp"
 
 namespace fem
 {
-class GaussLegendreTableTriangle
+/* The tables are computed in mpq_class and rounded to the other scalar types */
+template<typename Scalar>
+class BasicGaussLegendreTableTriangle
 {
 public:
     const auto& getWeights() const { return m_weights; }
     const auto& getAbscissas() const { return m_abscissas; }
 
 protected:
-    GaussLegendreTableTriangle() = default;
-    ~GaussLegendreTableTriangle() = default;
+    BasicGaussLegendreTableTriangle() = default;
+    ~BasicGaussLegendreTableTriangle() = default;
+
+    void addPoint(const mpq_class& weight, const mpq_class& u, const mpq_class& v);
 
 protected:
-    std::vector<mpq_class> m_weights;
-    std::vector<Vector2mpq> m_abscissas;
+    std::vector<Scalar> m_weights;
+    std::vector<Eigen::Vector2<Scalar>> m_abscissas;
 };
 
-class GaussLegendreTableTriangleQuadMapped : public GaussLegendreTableTriangle
+template<typename Scalar>
+class BasicGaussLegendreTableTriangleQuadMapped : public BasicGaussLegendreTableTriangle<Scalar>
 {
 public:
-    explicit GaussLegendreTableTriangleQuadMapped(uint32_t n);
+    explicit BasicGaussLegendreTableTriangleQuadMapped(uint32_t n);
 };
 
-class GaussLegendreTableTriangleCrowdingFree : public GaussLegendreTableTriangle
+template<typename Scalar>
+class BasicGaussLegendreTableTriangleCrowdingFree : public BasicGaussLegendreTableTriangle<Scalar>
 {
 public:
-    explicit GaussLegendreTableTriangleCrowdingFree(uint32_t n);
+    explicit BasicGaussLegendreTableTriangleCrowdingFree(uint32_t n);
 };
 
-inline const GaussLegendreTableTriangleQuadMapped glTableTriQuadMapped{100};
-inline const GaussLegendreTableTriangleCrowdingFree glTableTriCrowdingFree{100};
+using GaussLegendreTableTriangle = BasicGaussLegendreTableTriangle<mpq_class>;
+using GaussLegendreTableTriangleQuadMapped = BasicGaussLegendreTableTriangleQuadMapped<mpq_class>;
+using GaussLegendreTableTriangleCrowdingFree = BasicGaussLegendreTableTriangleCrowdingFree<mpq_class>;
+
+inline const GaussLegendreTableTriangleQuadMapped glTableTriQuadMapped{defaultGLTableSize};
+inline const GaussLegendreTableTriangleCrowdingFree glTableTriCrowdingFree{defaultGLTableSize};
 inline const GaussLegendreTableTriangle& defaultGLTableTri = glTableTriCrowdingFree;
+
+template<typename Scalar>
+const BasicGaussLegendreTableTriangle<Scalar>& getDefaultGLTableTri()
+{
+    if constexpr (std::is_same_v<Scalar, mpq_class>)
+    {
+        return defaultGLTableTri;
+    }
+    else
+    {
+        /* The same rule as defaultGLTableTri */
+        static const BasicGaussLegendreTableTriangleCrowdingFree<Scalar> table{defaultGLTableSize};
+        return table;
+    }
+}
 } // namespace fem
@@ -1,51 +1,54 @@
 #include "fem/math/quadrature/Quadrature2D.hpp"
 
+#include "fem/multiprecision/ScalarConversion.hpp"
+
 namespace fem
 {
 namespace
 {
-template<typename T>
-mpq_class doQuadrature(const BivariateFunction& f, const Element& element, const T& table)
+template<typename Scalar, typename T>
+Scalar doQuadrature(const BasicBivariateFunction<Scalar>& f, const T& table)
 {
-    mpq_class res = 0;
-    const AffineMap F = element.getReferenceElementMap();
-    auto g = [&f, &F](const Vector2mpq& x) -> mpq_class
-    {
-        return f(F(x));
-    };
+    Scalar res = 0;
     const auto& weights = table.getWeights();
     const auto& abscissas = table.getAbscissas();
     const uint32_t n = weights.size();
     #pragma omp parallel
     {
-        mpq_class subRes = 0;
+        Scalar subRes = 0;
         #pragma omp for
         for (int i = 0; i < n; i++)
         {
             const auto& w = weights.at(i);
             const auto& x = abscissas.at(i);
-            subRes += w * g(x);
+            subRes += w * f(x);
         }
         #pragma omp critical
         {
             res += subRes;
         }
     }
-    res *= F.A.determinant();
+    return res;
+}
+
+template<typename Scalar, typename T>
+Scalar doQuadrature(const BasicBivariateFunction<Scalar>& f, const Element& element, const T& table)
+{
+    const AffineMap F = element.getReferenceElementMap();
+    const BasicAffineMap<Scalar> F_s = convertAffineMap<Scalar>(F);
+    auto g = [&f, &F_s](const Eigen::Vector2<Scalar>& x) -> Scalar
+    {
+        return f(F_s(x));
+    };
+    Scalar res = doQuadrature<Scalar>(g, table);
+    res *= convertRational<Scalar>(F.A.determinant());
     return res;
 }
 } // namespace
 
 mpq_class integrateGaussLegendre(const BivariateFunction& f, const Element& element)
 {
-    if (element.getElementType() == ElementType_Parallelogram)
-    {
-        return integrateGaussLegendre(f, static_cast<const Parallelogram&>(element));
-    }
-    else
-    {
-        return integrateGaussLegendre(f, static_cast<const Triangle&>(element));
-    }
+    return integrateGaussLegendre<mpq_class>(f, element);
 }
 
 mpq_class integrateGaussLegendre(const BivariateFunction& f, const Parallelogram& quad, const GaussLegendreTableQuadrilateral& glTable)
@@ -57,4 +60,39 @@ mpq_class integrateGaussLegendre(const BivariateFunction& f, const Triangle& tri
 {
     return doQuadrature(f, tri, glTable);
 }
+
+template<typename Scalar>
+Scalar integrateGaussLegendre(const BasicBivariateFunction<Scalar>& f, const Element& element)
+{
+    if (element.getElementType() == ElementType_Parallelogram)
+    {
+        return doQuadrature(f, element, getDefaultGLTableQuad<Scalar>());
+    }
+    else
+    {
+        return doQuadrature(f, element, getDefaultGLTableTri<Scalar>());
+    }
+}
+
+template<typename Scalar>
+Scalar integrateGaussLegendreOverReferenceElement(const BasicBivariateFunction<Scalar>& f, ElementType elementType)
+{
+    if (elementType == ElementType_Parallelogram)
+    {
+        return doQuadrature(f, getDefaultGLTableQuad<Scalar>());
+    }
+    else
+    {
+        return doQuadrature(f, getDefaultGLTableTri<Scalar>());
+    }
+}
+
+#define INSTANTIATE_QUADRATURE_2D(Scalar) \
+    template Scalar integrateGaussLegendre<Scalar>(const BasicBivariateFunction<Scalar>&, const Element&); \
+    template Scalar integrateGaussLegendreOverReferenceElement<Scalar>(const BasicBivariateFunction<Scalar>&, ElementType);
+
+INSTANTIATE_QUADRATURE_2D(mpq_class)
+INSTANTIATE_QUADRATURE_2D(mpf_class)
+INSTANTIATE_QUADRATURE_2D(double)
+INSTANTIATE_QUADRATURE_2D(long double)
 } // namespace fem
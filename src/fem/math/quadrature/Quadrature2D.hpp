@@ -15,4 +15,11 @@ namespace fem
 mpq_class integrateGaussLegendre(const BivariateFunction& f, const Element& element);
 mpq_class integrateGaussLegendre(const BivariateFunction& f, const Parallelogram& quad, const GaussLegendreTableQuadrilateral& glTable = defaultGLTableQuad);
 mpq_class integrateGaussLegendre(const BivariateFunction& f, const Triangle& tri, const GaussLegendreTableTriangle& glTable = defaultGLTableTri);
+
+/* The same in another scalar type with the default tables, the element maps are rounded from the exact ones */
+template<typename Scalar>
+Scalar integrateGaussLegendre(const BasicBivariateFunction<Scalar>& f, const Element& element);
+/* f is in the coordinates of the reference element of the given type */
+template<typename Scalar>
+Scalar integrateGaussLegendreOverReferenceElement(const BasicBivariateFunction<Scalar>& f, ElementType elementType);
 } // namespace fem
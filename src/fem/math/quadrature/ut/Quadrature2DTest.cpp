@@ -3,6 +3,7 @@
 #include <numbers>
 
 #include "fem/math/polynomial/Polynomial2D.hpp"
+#include "fem/math/polynomial/PolynomialCalculus.hpp"
 #include "fem/math/quadrature/Quadrature2D.hpp"
 #include "fem/multiprecision/Arithmetic.hpp"
 
@@ -229,4 +230,21 @@ TEST(Quadrature2DTest, IntegrationOverTriangle3)
     const mpq_class resInt = integrateGaussLegendre(f, tri1i) + integrateGaussLegendre(f, tri2i) + integrateGaussLegendre(f, tri3i);
     EXPECT_NEAR(resInt.get_d(), 2.9072571636138239, 1e-7);
 }
+
+TEST(Quadrature2DTest, IntegrationInDouble)
+{
+    const Polynomial2D v("4/7x^5y^2 - 19/9x + 1");
+    const BasicPolynomial2D<double> v_d = convertPolynomial<double>(v);
+    const auto f = [&v](const Vector2mpq& x) -> mpq_class { return v(x); };
+    const auto f_d = [&v_d](const Eigen::Vector2d& x) -> double { return v_d(x); };
+
+    const Parallelogram quad(Node(1, 1), Node(2, 2), Node(2, 3), Node(1, 2));
+    EXPECT_NEAR(integrateGaussLegendre<double>(f_d, quad), integrateGaussLegendre(f, quad).get_d(), 1e-12);
+    const Triangle tri(Node(-4, 1), Node("-5/2", -3), Node(-1, 1));
+    EXPECT_NEAR(integrateGaussLegendre<double>(f_d, tri), integrateGaussLegendre(f, tri).get_d(), 1e-12);
+
+    EXPECT_NEAR(integrateGaussLegendreOverReferenceElement<double>(f_d, ElementType_Parallelogram), integrateOverReferenceElement(v, ElementType_Parallelogram).get_d(), 1e-13);
+    EXPECT_NEAR(integrateGaussLegendreOverReferenceElement<double>(f_d, ElementType_Triangle), integrateOverReferenceElement(v, ElementType_Triangle).get_d(), 1e-13);
+}
+
 } // namespace fem::ut
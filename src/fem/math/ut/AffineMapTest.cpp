@@ -54,4 +54,17 @@ TEST(AffineMapTest, Composition)
 
     EXPECT_EQ(compose(F, G), FG);
 }
+
+TEST(AffineMapTest, Conversion)
+{
+    Matrix2mpq A;
+    A.col(0) = Vector2mpq("1", "4/3");
+    A.col(1) = Vector2mpq("-1", "1");
+    Vector2mpq b("-1", "-1/2");
+    const BasicAffineMap<double> F = convertAffineMap<double>(AffineMap(A, b));
+    EXPECT_EQ(F.A(1,0), 4.0/3);
+    EXPECT_EQ(F({1, 0}), Eigen::Vector2d(0, 4.0/3 - 0.5));
+    EXPECT_EQ(F.inverse()({-2, 0.5}), Eigen::Vector2d(0, 1));
+}
+
 } // namespace fem::ut
@@ -0,0 +1,263 @@
+#include "fem/multiprecision/FractionFreeSolver.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/OrderingMethods>
+
+namespace fem
+{
+namespace
+{
+/* Upper triangular part of a row of the integer system, kept at the state after numOfSteps elimination steps */
+struct SparseRow
+{
+    std::vector<uint32_t> cols;
+    std::vector<mpz_class> values;
+    mpz_class rhs;
+    uint32_t numOfSteps = 0;
+};
+
+mpz_class lcmOfDenominators(const std::vector<const mpq_class*>& values)
+{
+    mpz_class res = 1;
+    for (const mpq_class* value : values)
+    {
+        mpz_lcm(res.get_mpz_t(), res.get_mpz_t(), value->get_den_mpz_t());
+    }
+    return res;
+}
+
+/* value * multiplier, where the product is known to be an integer */
+void scaleExactly(mpz_class& value, const mpq_class& multiplier)
+{
+    value *= multiplier.get_num();
+    mpz_divexact(value.get_mpz_t(), value.get_mpz_t(), multiplier.get_den_mpz_t());
+}
+
+/* Without coupling to the pivots in between, a row goes from step s to step t by the factor d_t / d_s */
+void bringToStep(SparseRow& row, uint32_t step, const std::vector<mpz_class>& pivots)
+{
+    if (row.numOfSteps == step)
+    {
+        return;
+    }
+    const mpz_class& numerator = pivots[step];
+    const mpz_class& denominator = pivots[row.numOfSteps];
+    for (mpz_class& value : row.values)
+    {
+        value *= numerator;
+        mpz_divexact(value.get_mpz_t(), value.get_mpz_t(), denominator.get_mpz_t());
+    }
+    row.rhs *= numerator;
+    mpz_divexact(row.rhs.get_mpz_t(), row.rhs.get_mpz_t(), denominator.get_mpz_t());
+    row.numOfSteps = step;
+}
+
+/* Eliminates the unknown k from the row i > k, a_ki being the coupling */
+void eliminate(SparseRow& row, uint32_t i, const SparseRow& pivotRow, const mpz_class& a_ki, const mpz_class& pivot, const mpz_class& previousPivot)
+{
+    std::vector<uint32_t> cols;
+    std::vector<mpz_class> values;
+    cols.reserve(row.cols.size() + pivotRow.cols.size());
+    values.reserve(row.cols.size() + pivotRow.cols.size());
+    size_t rowIdx = 0;
+    size_t pivotRowIdx = 0;
+    while (pivotRowIdx < pivotRow.cols.size() && pivotRow.cols[pivotRowIdx] < i)
+    {
+        pivotRowIdx++;
+    }
+    mpz_class value;
+    while (rowIdx < row.cols.size() || pivotRowIdx < pivotRow.cols.size())
+    {
+        const uint32_t rowCol = rowIdx < row.cols.size() ? row.cols[rowIdx] : UINT32_MAX;
+        const uint32_t pivotRowCol = pivotRowIdx < pivotRow.cols.size() ? pivotRow.cols[pivotRowIdx] : UINT32_MAX;
+        const uint32_t col = std::min(rowCol, pivotRowCol);
+        value = 0;
+        if (rowCol == col)
+        {
+            mpz_mul(value.get_mpz_t(), pivot.get_mpz_t(), row.values[rowIdx++].get_mpz_t());
+        }
+        if (pivotRowCol == col)
+        {
+            mpz_submul(value.get_mpz_t(), a_ki.get_mpz_t(), pivotRow.values[pivotRowIdx++].get_mpz_t());
+        }
+        mpz_divexact(value.get_mpz_t(), value.get_mpz_t(), previousPivot.get_mpz_t());
+        cols.push_back(col);
+        values.push_back(value);
+    }
+    row.cols = std::move(cols);
+    row.values = std::move(values);
+    value = pivot * row.rhs;
+    mpz_submul(value.get_mpz_t(), a_ki.get_mpz_t(), pivotRow.rhs.get_mpz_t());
+    mpz_divexact(row.rhs.get_mpz_t(), value.get_mpz_t(), previousPivot.get_mpz_t());
+}
+} // namespace
+
+std::optional<VectorXmpq> solveFractionFree(const SparseMatrixXmpq& A, const VectorXmpq& b)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.size());
+    const uint32_t n = b.size();
+    if (n == 0)
+    {
+        return VectorXmpq();
+    }
+
+    /* AMD ordering of the pattern, newToOld[k] being the original index of the k-th unknown */
+    Eigen::SparseMatrix<double> pattern(n, n);
+    {
+        std::vector<Eigen::Triplet<double>> triplets;
+        for (int j = 0; j < A.outerSize(); j++)
+        {
+            for (SparseMatrixXmpq::InnerIterator it(A, j); it; ++it)
+            {
+                triplets.emplace_back(it.row(), j, 1.0);
+            }
+        }
+        pattern.setFromTriplets(triplets.begin(), triplets.end());
+    }
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> permutation;
+    Eigen::AMDOrdering<int> ordering;
+    ordering(pattern, permutation);
+    std::vector<uint32_t> oldToNew(n);
+    std::vector<uint32_t> newToOld(n);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        newToOld[k] = permutation.indices()(k);
+        oldToNew[newToOld[k]] = k;
+    }
+
+    /* A' = L_A * A and b' = L_b * b are integral, and x = (L_A / L_b) * A'^-1 * b' */
+    std::vector<const mpq_class*> matrixValues;
+    for (int j = 0; j < A.outerSize(); j++)
+    {
+        for (SparseMatrixXmpq::InnerIterator it(A, j); it; ++it)
+        {
+            matrixValues.push_back(&it.value());
+        }
+    }
+    std::vector<const mpq_class*> rhsValues;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        rhsValues.push_back(&b(i));
+    }
+    const mpz_class matrixScale = lcmOfDenominators(matrixValues);
+    const mpz_class rhsScale = lcmOfDenominators(rhsValues);
+
+    std::vector<SparseRow> rows(n);
+    for (int j = 0; j < A.outerSize(); j++)
+    {
+        for (SparseMatrixXmpq::InnerIterator it(A, j); it; ++it)
+        {
+            const uint32_t newRow = oldToNew[it.row()];
+            const uint32_t newCol = oldToNew[j];
+            if (newCol < newRow || it.value() == 0)
+            {
+                continue;
+            }
+            mpz_class value = matrixScale;
+            scaleExactly(value, it.value());
+            rows[newRow].cols.push_back(newCol);
+            rows[newRow].values.push_back(std::move(value));
+        }
+    }
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < n; i++)
+    {
+        SparseRow& row = rows[i];
+        std::vector<uint32_t> order(row.cols.size());
+        for (uint32_t idx = 0; idx < order.size(); idx++)
+        {
+            order[idx] = idx;
+        }
+        std::sort(order.begin(), order.end(), [&row](uint32_t lhs, uint32_t rhs) { return row.cols[lhs] < row.cols[rhs]; });
+        std::vector<uint32_t> cols;
+        std::vector<mpz_class> values;
+        for (uint32_t idx : order)
+        {
+            cols.push_back(row.cols[idx]);
+            values.push_back(std::move(row.values[idx]));
+        }
+        row.cols = std::move(cols);
+        row.values = std::move(values);
+        row.rhs = rhsScale;
+        scaleExactly(row.rhs, b(newToOld[i]));
+    }
+
+    /* pivots[k] is the pivot of the step k-1, i.e. the k-th leading principal minor of A', and pivots[0] = 1 */
+    std::vector<mpz_class> pivots(n + 1);
+    pivots[0] = 1;
+    for (uint32_t k = 0; k < n; k++)
+    {
+        SparseRow& pivotRow = rows[k];
+        bringToStep(pivotRow, k, pivots);
+        if (pivotRow.cols.empty() || pivotRow.cols[0] != k || pivotRow.values[0] == 0)
+        {
+            /* Zero leading principal minor, the elimination cannot continue without pivoting */
+            return std::nullopt;
+        }
+        pivots[k + 1] = pivotRow.values[0];
+        #pragma omp parallel for schedule(dynamic)
+        for (int idx = 1; idx < pivotRow.cols.size(); idx++)
+        {
+            const mpz_class& a_ki = pivotRow.values[idx];
+            if (a_ki == 0)
+            {
+                continue;
+            }
+            const uint32_t i = pivotRow.cols[idx];
+            SparseRow& row = rows[i];
+            bringToStep(row, k, pivots);
+            eliminate(row, i, pivotRow, a_ki, pivots[k + 1], pivots[k]);
+            row.numOfSteps = k + 1;
+        }
+    }
+
+    /* By Cramer's rule y = det(A') * A'^-1 * b' is integral, so the back substitution stays in the integers */
+    const mpz_class& det = pivots[n];
+    std::vector<mpz_class> y(n);
+    mpz_class sum;
+    for (int k = n - 1; k >= 0; k--)
+    {
+        const SparseRow& row = rows[k];
+        sum = det * row.rhs;
+        for (size_t idx = 1; idx < row.cols.size(); idx++)
+        {
+            mpz_submul(sum.get_mpz_t(), row.values[idx].get_mpz_t(), y[row.cols[idx]].get_mpz_t());
+        }
+        mpz_divexact(y[k].get_mpz_t(), sum.get_mpz_t(), row.values[0].get_mpz_t());
+    }
+
+    VectorXmpq res(n);
+    const mpz_class denominator = det * rhsScale;
+    #pragma omp parallel for schedule(static)
+    for (int k = 0; k < n; k++)
+    {
+        mpq_class& x = res(newToOld[k]);
+        x.get_num() = y[k] * matrixScale;
+        x.get_den() = denominator;
+        x.canonicalize();
+    }
+    return res;
+}
+
+std::optional<VectorXmpq> solveFractionFree(const MatrixXmpq& A, const VectorXmpq& b)
+{
+    std::vector<Eigen::Triplet<mpq_class>> triplets;
+    for (int j = 0; j < A.cols(); j++)
+    {
+        for (int i = 0; i < A.rows(); i++)
+        {
+            if (A(i,j) != 0)
+            {
+                triplets.emplace_back(i, j, A(i,j));
+            }
+        }
+    }
+    SparseMatrixXmpq A_s(A.rows(), A.cols());
+    A_s.setFromTriplets(triplets.begin(), triplets.end());
+    return solveFractionFree(A_s, b);
+}
+} // namespace fem
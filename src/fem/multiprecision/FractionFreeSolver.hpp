@@ -0,0 +1,22 @@
+#pragma once
+
+#include <optional>
+
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/*
+ * Exact solution of A*x = b for a symmetric matrix whose leading principal minors are nonzero after a fill-reducing
+ * (AMD) reordering, e.g. a symmetric positive definite one. The denominators are cleared and the integer system is
+ * solved with fraction-free (Bareiss) elimination over mpz_class:
+ *     a_ij^(k+1) = (a_kk^(k) a_ij^(k) - a_ik^(k) a_kj^(k)) / a_(k-1)(k-1)^(k-1)
+ * where the division is exact, so the entries stay integers of the size of the minors of A instead of rationals
+ * that need a gcd after every operation. No pivoting is done, so the elimination keeps the sparsity pattern of the
+ * reordered matrix. A row not coupled to the pivot is only scaled by a ratio of consecutive pivots, which is applied
+ * lazily when the row is next needed.
+ * Returns nothing if a leading principal minor of the reordered matrix is zero, e.g. if A is singular.
+ */
+std::optional<VectorXmpq> solveFractionFree(const SparseMatrixXmpq& A, const VectorXmpq& b);
+std::optional<VectorXmpq> solveFractionFree(const MatrixXmpq& A, const VectorXmpq& b);
+} // namespace fem
@@ -0,0 +1,124 @@
+#include "fem/multiprecision/ModularArithmetic.hpp"
+
+#include <cassert>
+
+namespace fem
+{
+uint64_t powMod(uint64_t base, uint64_t exp, uint64_t prime)
+{
+    uint64_t res = 1 % prime;
+    base %= prime;
+    while (exp > 0)
+    {
+        if (exp & 1)
+        {
+            res = mulMod(res, base, prime);
+        }
+        base = mulMod(base, base, prime);
+        exp >>= 1;
+    }
+    return res;
+}
+
+uint64_t invMod(uint64_t a, uint64_t prime)
+{
+    assert(a % prime != 0);
+    return powMod(a, prime - 2, prime);
+}
+
+std::optional<uint64_t> reduceRational(const mpq_class& x, uint64_t prime)
+{
+    static_assert(sizeof(unsigned long) == sizeof(uint64_t));
+    const uint64_t den = mpz_fdiv_ui(x.get_den_mpz_t(), prime);
+    if (den == 0)
+    {
+        return std::nullopt;
+    }
+    const uint64_t num = mpz_fdiv_ui(x.get_num_mpz_t(), prime);
+    return mulMod(num, invMod(den, prime), prime);
+}
+
+std::optional<ModularSparseMatrix> reduceRational(const SparseMatrixXmpq& A, uint64_t prime)
+{
+    std::vector<Eigen::Triplet<uint64_t>> triplets;
+    triplets.reserve(A.nonZeros());
+    for (int j = 0; j < A.outerSize(); j++)
+    {
+        for (SparseMatrixXmpq::InnerIterator it(A, j); it; ++it)
+        {
+            const std::optional<uint64_t> value = reduceRational(it.value(), prime);
+            if (!value)
+            {
+                return std::nullopt;
+            }
+            triplets.emplace_back(it.row(), j, *value);
+        }
+    }
+    ModularSparseMatrix res(A.rows(), A.cols());
+    res.setFromTriplets(triplets.begin(), triplets.end());
+    return res;
+}
+
+std::optional<std::vector<uint64_t>> reduceRational(const VectorXmpq& b, uint64_t prime)
+{
+    std::vector<uint64_t> res(b.size());
+    for (int i = 0; i < b.size(); i++)
+    {
+        const std::optional<uint64_t> value = reduceRational(b(i), prime);
+        if (!value)
+        {
+            return std::nullopt;
+        }
+        res[i] = *value;
+    }
+    return res;
+}
+
+std::optional<mpq_class> reconstructRational(const mpz_class& u, const mpz_class& modulus)
+{
+    /* Extended Euclidean algorithm on (modulus, u) stopped at the first remainder below the bound */
+    mpz_class bound = modulus / 2;
+    mpz_sqrt(bound.get_mpz_t(), bound.get_mpz_t());
+    mpz_class r0 = modulus;
+    mpz_class r1 = u % modulus;
+    if (r1 < 0)
+    {
+        r1 += modulus;
+    }
+    mpz_class t0 = 0;
+    mpz_class t1 = 1;
+    mpz_class q;
+    mpz_class tmp;
+    while (r1 > bound)
+    {
+        mpz_fdiv_q(q.get_mpz_t(), r0.get_mpz_t(), r1.get_mpz_t());
+        tmp = r0 - q * r1;
+        r0 = r1;
+        r1 = tmp;
+        tmp = t0 - q * t1;
+        t0 = t1;
+        t1 = tmp;
+    }
+    if (abs(t1) > bound || gcd(r1, t1) != 1)
+    {
+        return std::nullopt;
+    }
+    mpq_class res;
+    res.get_num() = r1;
+    res.get_den() = t1;
+    res.canonicalize();
+    return res;
+}
+
+ModularPrimeSequence::ModularPrimeSequence()
+    : m_prime(mpz_class(1) << 61)
+{
+}
+
+uint64_t ModularPrimeSequence::next()
+{
+    mpz_nextprime(m_prime.get_mpz_t(), m_prime.get_mpz_t());
+    assert(m_prime < (mpz_class(1) << 62));
+    return m_prime.get_ui();
+}
+} // namespace fem
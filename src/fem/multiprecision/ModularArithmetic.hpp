@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/* Matrix of residues modulo a prime */
+using ModularSparseMatrix = Eigen::SparseMatrix<uint64_t>;
+
+/* Residues are in [0, prime) with prime < 2^62, so the sum of two residues does not overflow */
+inline uint64_t addMod(uint64_t a, uint64_t b, uint64_t prime)
+{
+    const uint64_t res = a + b;
+    return (res >= prime) ? res - prime : res;
+}
+
+inline uint64_t subMod(uint64_t a, uint64_t b, uint64_t prime)
+{
+    return (a >= b) ? a - b : a + (prime - b);
+}
+
+inline uint64_t mulMod(uint64_t a, uint64_t b, uint64_t prime)
+{
+    return static_cast<uint64_t>(static_cast<unsigned __int128>(a) * b % prime);
+}
+
+uint64_t powMod(uint64_t base, uint64_t exp, uint64_t prime);
+/* a must not be divisible by prime */
+uint64_t invMod(uint64_t a, uint64_t prime);
+
+/* Residue of x modulo prime, nothing if prime divides the denominator */
+std::optional<uint64_t> reduceRational(const mpq_class& x, uint64_t prime);
+
+/* Residues of the entries, nothing if prime divides a denominator */
+std::optional<ModularSparseMatrix> reduceRational(const SparseMatrixXmpq& A, uint64_t prime);
+std::optional<std::vector<uint64_t>> reduceRational(const VectorXmpq& b, uint64_t prime);
+
+/* Rational n/d with n = u*d (mod modulus) and |n|, d <= sqrt(modulus/2), which is unique if it exists */
+std::optional<mpq_class> reconstructRational(const mpz_class& u, const mpz_class& modulus);
+
+/* The consecutive primes above 2^61, all of which are below 2^62 */
+class ModularPrimeSequence
+{
+public:
+    ModularPrimeSequence();
+
+    uint64_t next();
+
+private:
+    mpz_class m_prime;
+};
+} // namespace fem
@@ -0,0 +1,418 @@
+#include "fem/multiprecision/MultiModularSolver.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include <Eigen/OrderingMethods>
+#include <omp.h>
+
+namespace fem
+{
+namespace
+{
+/* Upper triangular part of a row of the reordered system */
+struct ModularRow
+{
+    std::vector<uint32_t> cols;
+    std::vector<uint64_t> values;
+};
+
+/* Residues of the solution combined by the Chinese remainder theorem */
+struct CrtAccumulator
+{
+    mpz_class modulus = 1;
+    std::vector<mpz_class> residues;
+};
+
+/*
+ * b' = scale * b is integral and split into base 2^digitBits digits, digits[i * numOfDigits + k] being the k-th digit
+ * of b'_i with the sign of b'_i. A^-1 times a digit vector needs far fewer primes than A^-1 b' when the entries of
+ * b' are long compared to det(A), and x = (sum_k 2^(k*digitBits) A^-1 digits_k) / scale.
+ */
+struct RightHandSideDigits
+{
+    static constexpr uint32_t digitBits = 4096;
+
+    mpz_class scale;
+    uint32_t numOfDigits;
+    std::vector<mpz_class> digits;
+};
+
+RightHandSideDigits splitIntoDigits(const VectorXmpq& b)
+{
+    RightHandSideDigits res;
+    res.scale = 1;
+    size_t maxBits = 1;
+    for (int i = 0; i < b.size(); i++)
+    {
+        mpz_lcm(res.scale.get_mpz_t(), res.scale.get_mpz_t(), b(i).get_den_mpz_t());
+    }
+    std::vector<mpz_class> scaled(b.size());
+    for (int i = 0; i < b.size(); i++)
+    {
+        scaled[i] = res.scale / b(i).get_den() * b(i).get_num();
+        maxBits = std::max(maxBits, mpz_sizeinbase(scaled[i].get_mpz_t(), 2));
+    }
+    res.numOfDigits = (maxBits + RightHandSideDigits::digitBits - 1) / RightHandSideDigits::digitBits;
+    res.digits.resize(b.size() * res.numOfDigits);
+    mpz_class magnitude;
+    for (int i = 0; i < b.size(); i++)
+    {
+        magnitude = abs(scaled[i]);
+        for (uint32_t k = 0; k < res.numOfDigits; k++)
+        {
+            mpz_class& digit = res.digits[i * res.numOfDigits + k];
+            mpz_fdiv_r_2exp(digit.get_mpz_t(), magnitude.get_mpz_t(), RightHandSideDigits::digitBits);
+            mpz_fdiv_q_2exp(magnitude.get_mpz_t(), magnitude.get_mpz_t(), RightHandSideDigits::digitBits);
+            if (scaled[i] < 0)
+            {
+                digit = -digit;
+            }
+        }
+    }
+    return res;
+}
+
+std::vector<uint64_t> reduceDigits(const RightHandSideDigits& digits, uint64_t prime)
+{
+    std::vector<uint64_t> res(digits.digits.size());
+    for (size_t idx = 0; idx < res.size(); idx++)
+    {
+        res[idx] = mpz_fdiv_ui(digits.digits[idx].get_mpz_t(), prime);
+    }
+    return res;
+}
+
+/* AMD ordering of the pattern, newToOld[k] being the original index of the k-th unknown */
+std::vector<uint32_t> computeOrdering(const ModularSparseMatrix& A)
+{
+    const uint32_t n = A.rows();
+    Eigen::SparseMatrix<double> pattern(n, n);
+    std::vector<Eigen::Triplet<double>> triplets;
+    for (int j = 0; j < A.outerSize(); j++)
+    {
+        for (ModularSparseMatrix::InnerIterator it(A, j); it; ++it)
+        {
+            triplets.emplace_back(it.row(), j, 1.0);
+        }
+    }
+    pattern.setFromTriplets(triplets.begin(), triplets.end());
+    Eigen::PermutationMatrix<Eigen::Dynamic, Eigen::Dynamic, int> permutation;
+    Eigen::AMDOrdering<int> ordering;
+    ordering(pattern, permutation);
+    std::vector<uint32_t> newToOld(n);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        newToOld[k] = permutation.indices()(k);
+    }
+    return newToOld;
+}
+
+/* row -= multiplier * (the part of pivotRow from the column i onwards) */
+void eliminate(ModularRow& row, uint32_t i, const ModularRow& pivotRow, uint64_t multiplier, uint64_t prime)
+{
+    std::vector<uint32_t> cols;
+    std::vector<uint64_t> values;
+    cols.reserve(row.cols.size() + pivotRow.cols.size());
+    values.reserve(row.cols.size() + pivotRow.cols.size());
+    size_t rowIdx = 0;
+    size_t pivotRowIdx = 0;
+    while (pivotRowIdx < pivotRow.cols.size() && pivotRow.cols[pivotRowIdx] < i)
+    {
+        pivotRowIdx++;
+    }
+    while (rowIdx < row.cols.size() || pivotRowIdx < pivotRow.cols.size())
+    {
+        const uint32_t rowCol = rowIdx < row.cols.size() ? row.cols[rowIdx] : UINT32_MAX;
+        const uint32_t pivotRowCol = pivotRowIdx < pivotRow.cols.size() ? pivotRow.cols[pivotRowIdx] : UINT32_MAX;
+        const uint32_t col = std::min(rowCol, pivotRowCol);
+        uint64_t value = 0;
+        if (rowCol == col)
+        {
+            value = row.values[rowIdx++];
+        }
+        if (pivotRowCol == col)
+        {
+            value = subMod(value, mulMod(multiplier, pivotRow.values[pivotRowIdx++], prime), prime);
+        }
+        cols.push_back(col);
+        values.push_back(value);
+    }
+    row.cols = std::move(cols);
+    row.values = std::move(values);
+}
+
+/*
+ * Solves A*X = B modulo prime without pivoting in the given order, or returns nothing if a pivot vanishes. B has
+ * numOfRhs columns and is stored row by row, as is the result.
+ */
+std::optional<std::vector<uint64_t>> solveModular(const ModularSparseMatrix& A, const std::vector<uint64_t>& B, uint32_t numOfRhs, const std::vector<uint32_t>& newToOld, uint64_t prime)
+{
+    const uint32_t n = newToOld.size();
+    std::vector<uint32_t> oldToNew(n);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        oldToNew[newToOld[k]] = k;
+    }
+    std::vector<ModularRow> rows(n);
+    for (int j = 0; j < A.outerSize(); j++)
+    {
+        for (ModularSparseMatrix::InnerIterator it(A, j); it; ++it)
+        {
+            const uint32_t newRow = oldToNew[it.row()];
+            const uint32_t newCol = oldToNew[j];
+            if (newCol < newRow || it.value() == 0)
+            {
+                continue;
+            }
+            rows[newRow].cols.push_back(newCol);
+            rows[newRow].values.push_back(it.value());
+        }
+    }
+    std::vector<uint64_t> rhs(n * numOfRhs);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        ModularRow& row = rows[k];
+        std::vector<uint32_t> order(row.cols.size());
+        for (uint32_t idx = 0; idx < order.size(); idx++)
+        {
+            order[idx] = idx;
+        }
+        std::sort(order.begin(), order.end(), [&row](uint32_t lhs, uint32_t rhs) { return row.cols[lhs] < row.cols[rhs]; });
+        ModularRow sortedRow;
+        for (uint32_t idx : order)
+        {
+            sortedRow.cols.push_back(row.cols[idx]);
+            sortedRow.values.push_back(row.values[idx]);
+        }
+        row = std::move(sortedRow);
+        std::copy_n(B.begin() + newToOld[k] * numOfRhs, numOfRhs, rhs.begin() + k * numOfRhs);
+    }
+
+    std::vector<uint64_t> pivotInverses(n);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        const ModularRow& pivotRow = rows[k];
+        if (pivotRow.cols.empty() || pivotRow.cols[0] != k || pivotRow.values[0] == 0)
+        {
+            return std::nullopt;
+        }
+        pivotInverses[k] = invMod(pivotRow.values[0], prime);
+        for (size_t idx = 1; idx < pivotRow.cols.size(); idx++)
+        {
+            if (pivotRow.values[idx] == 0)
+            {
+                continue;
+            }
+            const uint32_t i = pivotRow.cols[idx];
+            const uint64_t multiplier = mulMod(pivotRow.values[idx], pivotInverses[k], prime);
+            eliminate(rows[i], i, pivotRow, multiplier, prime);
+            for (uint32_t c = 0; c < numOfRhs; c++)
+            {
+                rhs[i * numOfRhs + c] = subMod(rhs[i * numOfRhs + c], mulMod(multiplier, rhs[k * numOfRhs + c], prime), prime);
+            }
+        }
+    }
+
+    std::vector<uint64_t> y(n * numOfRhs);
+    for (int k = n - 1; k >= 0; k--)
+    {
+        const ModularRow& row = rows[k];
+        uint64_t* y_k = y.data() + k * numOfRhs;
+        std::copy_n(rhs.begin() + k * numOfRhs, numOfRhs, y_k);
+        for (size_t idx = 1; idx < row.cols.size(); idx++)
+        {
+            const uint64_t* y_col = y.data() + row.cols[idx] * numOfRhs;
+            for (uint32_t c = 0; c < numOfRhs; c++)
+            {
+                y_k[c] = subMod(y_k[c], mulMod(row.values[idx], y_col[c], prime), prime);
+            }
+        }
+        for (uint32_t c = 0; c < numOfRhs; c++)
+        {
+            y_k[c] = mulMod(y_k[c], pivotInverses[k], prime);
+        }
+    }
+    std::vector<uint64_t> res(n * numOfRhs);
+    for (uint32_t k = 0; k < n; k++)
+    {
+        std::copy_n(y.begin() + k * numOfRhs, numOfRhs, res.begin() + newToOld[k] * numOfRhs);
+    }
+    return res;
+}
+
+void combine(CrtAccumulator& crt, const std::vector<uint64_t>& x, uint64_t prime)
+{
+    if (crt.residues.empty())
+    {
+        crt.residues.assign(x.begin(), x.end());
+        crt.modulus = prime;
+        return;
+    }
+    /* u' = u + M * ((x - u) / M mod prime) */
+    const uint64_t modulusInverse = invMod(mpz_fdiv_ui(crt.modulus.get_mpz_t(), prime), prime);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < x.size(); i++)
+    {
+        const uint64_t residue = mpz_fdiv_ui(crt.residues[i].get_mpz_t(), prime);
+        const uint64_t t = mulMod(subMod(x[i], residue, prime), modulusInverse, prime);
+        mpz_addmul_ui(crt.residues[i].get_mpz_t(), crt.modulus.get_mpz_t(), t);
+    }
+    crt.modulus *= prime;
+}
+
+/* With D the common denominator of the entries so far, u_i*D is reconstructed, which is usually an integer already */
+std::optional<VectorXmpq> reconstruct(const CrtAccumulator& crt)
+{
+    const uint32_t n = crt.residues.size();
+    VectorXmpq res(n);
+    mpz_class denominator = 1;
+    mpz_class u;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        u = crt.residues[i] * denominator;
+        mpz_mod(u.get_mpz_t(), u.get_mpz_t(), crt.modulus.get_mpz_t());
+        const std::optional<mpq_class> value = reconstructRational(u, crt.modulus);
+        if (!value)
+        {
+            return std::nullopt;
+        }
+        res(i) = *value / denominator;
+        denominator *= value->get_den();
+    }
+    return res;
+}
+
+bool matches(const VectorXmpq& candidate, const std::vector<uint64_t>& x, uint64_t prime)
+{
+    for (uint32_t i = 0; i < x.size(); i++)
+    {
+        const std::optional<uint64_t> value = reduceRational(candidate(i), prime);
+        if (!value || *value != x[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+std::optional<VectorXmpq> solveMultiModular(const ModularMatrixFunction& reduceMatrix, const VectorXmpq& b)
+{
+    const uint32_t n = b.size();
+    if (n == 0)
+    {
+        return VectorXmpq();
+    }
+
+    ModularPrimeSequence primes;
+    std::optional<ModularSparseMatrix> firstMatrix;
+    while (!firstMatrix)
+    {
+        firstMatrix = reduceMatrix(primes.next());
+    }
+    assert(firstMatrix->rows() == n && firstMatrix->cols() == n);
+    const std::vector<uint32_t> newToOld = computeOrdering(*firstMatrix);
+    firstMatrix.reset();
+    const RightHandSideDigits digits = splitIntoDigits(b);
+
+    /* The candidate holds A^-1 digits_k row by row like the digits */
+    const int batchSize = std::max(omp_get_max_threads(), 4);
+    const uint32_t maxNumOfFailedBatches = 4;
+    CrtAccumulator crt;
+    std::optional<VectorXmpq> candidate;
+    uint32_t numOfFailedBatches = 0;
+    while (true)
+    {
+        std::vector<uint64_t> batch(batchSize);
+        for (uint64_t& prime : batch)
+        {
+            prime = primes.next();
+        }
+        std::vector<std::optional<std::vector<uint64_t>>> solutions(batchSize);
+        #pragma omp parallel for schedule(dynamic)
+        for (int idx = 0; idx < batchSize; idx++)
+        {
+            const std::optional<ModularSparseMatrix> A_p = reduceMatrix(batch[idx]);
+            if (A_p)
+            {
+                solutions[idx] = solveModular(*A_p, reduceDigits(digits, batch[idx]), digits.numOfDigits, newToOld, batch[idx]);
+            }
+        }
+
+        bool confirmed = true;
+        bool anySolved = false;
+        for (int idx = 0; idx < batchSize; idx++)
+        {
+            if (solutions[idx])
+            {
+                anySolved = true;
+                confirmed = confirmed && candidate && matches(*candidate, *solutions[idx], batch[idx]);
+            }
+        }
+        if (!anySolved)
+        {
+            /* A zero leading principal minor is zero modulo every prime */
+            numOfFailedBatches++;
+            if (numOfFailedBatches == maxNumOfFailedBatches)
+            {
+                return std::nullopt;
+            }
+            continue;
+        }
+        if (confirmed)
+        {
+            break;
+        }
+        for (int idx = 0; idx < batchSize; idx++)
+        {
+            if (solutions[idx])
+            {
+                combine(crt, *solutions[idx], batch[idx]);
+            }
+        }
+        candidate = reconstruct(crt);
+    }
+
+    VectorXmpq res(n);
+    #pragma omp parallel for schedule(static)
+    for (int i = 0; i < n; i++)
+    {
+        mpq_class& x = res(i);
+        x = 0;
+        for (int k = digits.numOfDigits - 1; k >= 0; k--)
+        {
+            mpq_mul_2exp(x.get_mpq_t(), x.get_mpq_t(), RightHandSideDigits::digitBits);
+            x += (*candidate)(i * digits.numOfDigits + k);
+        }
+        x /= digits.scale;
+    }
+    return res;
+}
+
+std::optional<VectorXmpq> solveMultiModular(const SparseMatrixXmpq& A, const VectorXmpq& b)
+{
+    assert(A.rows() == A.cols() && A.rows() == b.size());
+    return solveMultiModular([&A](uint64_t prime) { return reduceRational(A, prime); }, b);
+}
+
+std::optional<VectorXmpq> solveMultiModular(const MatrixXmpq& A, const VectorXmpq& b)
+{
+    std::vector<Eigen::Triplet<mpq_class>> triplets;
+    for (int j = 0; j < A.cols(); j++)
+    {
+        for (int i = 0; i < A.rows(); i++)
+        {
+            if (A(i,j) != 0)
+            {
+                triplets.emplace_back(i, j, A(i,j));
+            }
+        }
+    }
+    SparseMatrixXmpq A_s(A.rows(), A.cols());
+    A_s.setFromTriplets(triplets.begin(), triplets.end());
+    return solveMultiModular(A_s, b);
+}
+} // namespace fem
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include "fem/multiprecision/ModularArithmetic.hpp"
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/*
+ * Exact solution of A*x = b for a symmetric matrix whose leading principal minors are nonzero after a fill-reducing
+ * (AMD) reordering, e.g. a symmetric positive definite one. A is reduced modulo 62-bit primes and each system is
+ * solved by sparse elimination in uint64_t arithmetic, the primes of a batch in parallel. The residues of the
+ * solution are combined with the Chinese remainder theorem and recovered by rational reconstruction, with the common
+ * denominator of the entries found so far taken out first. Batches of primes are added until the next batch
+ * confirms the reconstruction. A prime dividing a denominator or a pivot is skipped.
+ * The load vectors can have far longer entries than the matrix, so b is scaled to integers and split into 4096-bit
+ * digits. Every prime solves for all the digit vectors at once, and the number of primes depends on det(A) and the
+ * digit length only.
+ * Returns nothing if no prime of several batches gives a solution, i.e. if a leading principal minor of the reordered
+ * matrix is zero, e.g. if A is singular.
+ */
+std::optional<VectorXmpq> solveMultiModular(const SparseMatrixXmpq& A, const VectorXmpq& b);
+std::optional<VectorXmpq> solveMultiModular(const MatrixXmpq& A, const VectorXmpq& b);
+
+/* Returns A modulo prime, or nothing if prime divides a denominator of A. Called concurrently for different primes. */
+using ModularMatrixFunction = std::function<std::optional<ModularSparseMatrix>(uint64_t prime)>;
+/* As above, with the matrix given by its residues, e.g. assembled directly modulo the primes */
+std::optional<VectorXmpq> solveMultiModular(const ModularMatrixFunction& reduceMatrix, const VectorXmpq& b);
+} // namespace fem
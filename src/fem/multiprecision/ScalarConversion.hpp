@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "fem/multiprecision/Types.hpp"
+
+namespace fem
+{
+/* Rounds an exact rational to the given scalar type, to nearest for double and long double. Exact for mpq_class. */
+template<typename Scalar>
+Scalar convertRational(const mpq_class& x);
+
+template<>
+inline mpq_class convertRational<mpq_class>(const mpq_class& x)
+{
+    return x;
+}
+
+/* Uses the default precision set by mpf_set_default_prec */
+template<>
+inline mpf_class convertRational<mpf_class>(const mpq_class& x)
+{
+    return mpf_class(x);
+}
+
+/*
+ * Rounds x to the nearest value of the binary floating-point type Float, ties to even. gmpxx only truncates (get_d) and
+ * has no long double support, so the quotient is rounded to the mantissa length by hand. Assumes the value is in the
+ * normal range of Float.
+ */
+template<typename Float>
+Float roundRational(const mpq_class& x)
+{
+    constexpr int digits = std::numeric_limits<Float>::digits;
+    static_assert(std::numeric_limits<Float>::radix == 2 && digits <= 64);
+    if (x == 0)
+    {
+        return 0;
+    }
+    const mpz_class num = abs(x.get_num());
+    const mpz_class& den = x.get_den();
+    /* q = floor(|x| * 2^-e) has digits or digits + 1 bits with this e, in the latter case e is incremented once */
+    long exponent = static_cast<long>(mpz_sizeinbase(num.get_mpz_t(), 2)) - static_cast<long>(mpz_sizeinbase(den.get_mpz_t(), 2)) - digits;
+    mpz_class q;
+    mpz_class r;
+    mpz_class scaledDen;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        mpz_class scaledNum = num;
+        scaledDen = den;
+        if (exponent < 0)
+        {
+            mpz_mul_2exp(scaledNum.get_mpz_t(), scaledNum.get_mpz_t(), -exponent);
+        }
+        else
+        {
+            mpz_mul_2exp(scaledDen.get_mpz_t(), scaledDen.get_mpz_t(), exponent);
+        }
+        mpz_fdiv_qr(q.get_mpz_t(), r.get_mpz_t(), scaledNum.get_mpz_t(), scaledDen.get_mpz_t());
+        if (mpz_sizeinbase(q.get_mpz_t(), 2) <= digits)
+        {
+            break;
+        }
+        exponent++;
+    }
+    const int roundingDirection = cmp(2 * r, scaledDen);
+    if (roundingDirection > 0 || (roundingDirection == 0 && mpz_odd_p(q.get_mpz_t())))
+    {
+        q += 1;
+        if (mpz_sizeinbase(q.get_mpz_t(), 2) > digits)
+        {
+            q >>= 1;
+            exponent++;
+        }
+    }
+    static_assert(sizeof(unsigned long) == sizeof(uint64_t));
+    const Float res = std::ldexp(static_cast<Float>(mpz_get_ui(q.get_mpz_t())), exponent);
+    return (x < 0) ? -res : res;
+}
+
+template<>
+inline double convertRational<double>(const mpq_class& x)
+{
+    return roundRational<double>(x);
+}
+
+template<>
+inline long double convertRational<long double>(const mpq_class& x)
+{
+    return roundRational<long double>(x);
+}
+
+/* The inverse conversions are exact */
+inline mpq_class convertToRational(const mpq_class& x)
+{
+    return x;
+}
+
+inline mpq_class convertToRational(const mpf_class& x)
+{
+    return mpq_class(x);
+}
+
+inline mpq_class convertToRational(double x)
+{
+    return mpq_class(x);
+}
+
+inline mpq_class convertToRational(long double x)
+{
+    const double hi = static_cast<double>(x);
+    const double lo = static_cast<double>(x - hi);
+    return mpq_class(hi) + mpq_class(lo);
+}
+} // namespace fem
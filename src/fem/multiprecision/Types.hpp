@@ -1,8 +1,14 @@
 #pragma once
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
 #include <gmpxx.h>
 
+/* mpf_class has no infinities or NaNs. Eigen's decompositions look these up through ADL. */
+inline bool isfinite(const mpf_class&) { return true; }
+inline bool isinf(const mpf_class&) { return false; }
+inline bool isnan(const mpf_class&) { return false; }
+
 namespace fem
 {
 using Vector2mpq = Eigen::Matrix<mpq_class, 2, 1>;
@@ -11,6 +17,7 @@ using Matrix2mpq = Eigen::Matrix<mpq_class, 2, 2>;
 using Matrix3mpq = Eigen::Matrix<mpq_class, 3, 3>;
 using MatrixXmpq = Eigen::Matrix<mpq_class, Eigen::Dynamic, Eigen::Dynamic>;
 using VectorXmpq = Eigen::Matrix<mpq_class, Eigen::Dynamic, 1>;
+using SparseMatrixXmpq = Eigen::SparseMatrix<mpq_class>;
 
 using Vector2mpf = Eigen::Matrix<mpf_class, 2, 1>;
 using Vector3mpf = Eigen::Matrix<mpf_class, 3, 1>;
@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+
+#include "fem/multiprecision/ModularArithmetic.hpp"
+
+namespace fem::ut
+{
+TEST(ModularArithmeticTest, PrimesAreBelow2To62)
+{
+    ModularPrimeSequence primes;
+    uint64_t previous = uint64_t(1) << 61;
+    for (int i = 0; i < 10; i++)
+    {
+        const uint64_t prime = primes.next();
+        EXPECT_GT(prime, previous);
+        EXPECT_LT(prime, uint64_t(1) << 62);
+        EXPECT_EQ(powMod(3, prime - 1, prime), 1);
+        previous = prime;
+    }
+}
+
+TEST(ModularArithmeticTest, ReduceRational)
+{
+    const uint64_t prime = ModularPrimeSequence().next();
+    const mpq_class x = mpq_class(-7) / 3;
+    const std::optional<uint64_t> residue = reduceRational(x, prime);
+    ASSERT_TRUE(residue.has_value());
+    EXPECT_EQ(mulMod(*residue, 3, prime), prime - 7);
+    EXPECT_EQ(mulMod(invMod(*residue, prime), *residue, prime), 1);
+    EXPECT_FALSE(reduceRational(mpq_class(1) / prime, prime).has_value());
+}
+
+TEST(ModularArithmeticTest, ReconstructRational)
+{
+    ModularPrimeSequence primes;
+    const mpz_class modulus = mpz_class(primes.next()) * primes.next();
+    for (const mpq_class& x : {mpq_class(0), mpq_class(-5), mpq_class(mpq_class(123456789) / 987654321), mpq_class(mpq_class(-31) / 1000003)})
+    {
+        mpz_class u;
+        mpz_class denominatorInverse;
+        mpz_invert(denominatorInverse.get_mpz_t(), x.get_den_mpz_t(), modulus.get_mpz_t());
+        u = x.get_num() * denominatorInverse;
+        mpz_mod(u.get_mpz_t(), u.get_mpz_t(), modulus.get_mpz_t());
+        const std::optional<mpq_class> res = reconstructRational(u, modulus);
+        ASSERT_TRUE(res.has_value());
+        EXPECT_EQ(*res, x);
+    }
+}
+} // namespace fem::ut
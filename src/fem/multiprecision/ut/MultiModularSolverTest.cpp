@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <vector>
+
+#include "fem/multiprecision/FractionFreeSolver.hpp"
+#include "fem/multiprecision/MultiModularSolver.hpp"
+
+namespace fem::ut
+{
+TEST(MultiModularSolverTest, HilbertMatrix)
+{
+    const int n = 12;
+    MatrixXmpq A(n, n);
+    VectorXmpq b(n);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            A(i,j) = mpq_class(1, i + j + 1);
+        }
+        b(i) = mpq_class(i % 3 - 1) / (i + 2);
+    }
+    const std::optional<VectorXmpq> x = solveMultiModular(A, b);
+    ASSERT_TRUE(x);
+    EXPECT_EQ(A * *x, b);
+    EXPECT_EQ(x, solveFractionFree(A, b));
+}
+
+TEST(MultiModularSolverTest, SparseSystem)
+{
+    /* 2D Laplacian with rational coefficients on a 7x6 grid, unknowns numbered row by row */
+    const int nx = 7;
+    const int ny = 6;
+    const int n = nx * ny;
+    std::vector<Eigen::Triplet<mpq_class>> triplets;
+    for (int iy = 0; iy < ny; iy++)
+    {
+        for (int ix = 0; ix < nx; ix++)
+        {
+            const int i = iy * nx + ix;
+            triplets.emplace_back(i, i, mpq_class(4) + mpq_class(1, i + 3));
+            if (ix + 1 < nx)
+            {
+                triplets.emplace_back(i, i + 1, mpq_class(-2, 3));
+                triplets.emplace_back(i + 1, i, mpq_class(-2, 3));
+            }
+            if (iy + 1 < ny)
+            {
+                triplets.emplace_back(i, i + nx, mpq_class(-5, 7));
+                triplets.emplace_back(i + nx, i, mpq_class(-5, 7));
+            }
+        }
+    }
+    SparseMatrixXmpq A(n, n);
+    A.setFromTriplets(triplets.begin(), triplets.end());
+    VectorXmpq b(n);
+    for (int i = 0; i < n; i++)
+    {
+        b(i) = mpq_class(i - 7) / (2 * i + 1);
+    }
+    const std::optional<VectorXmpq> x = solveMultiModular(A, b);
+    ASSERT_TRUE(x);
+    EXPECT_EQ(VectorXmpq(A * *x), b);
+    EXPECT_EQ(x, solveFractionFree(A, b));
+}
+
+TEST(MultiModularSolverTest, LongRightHandSide)
+{
+    /* The entries of b span several digits and have different signs */
+    const int n = 6;
+    MatrixXmpq A(n, n);
+    VectorXmpq b(n);
+    for (int i = 0; i < n; i++)
+    {
+        for (int j = 0; j < n; j++)
+        {
+            A(i,j) = (i == j) ? mpq_class(3) : mpq_class(-1) / (i + j + 2);
+        }
+        mpz_class numerator;
+        mpz_ui_pow_ui(numerator.get_mpz_t(), 3 + i, 5000 + 1000 * i);
+        b(i) = mpq_class(numerator + i) / (i % 2 == 0 ? 7 : -11);
+    }
+    const std::optional<VectorXmpq> x = solveMultiModular(A, b);
+    ASSERT_TRUE(x);
+    EXPECT_EQ(A * *x, b);
+    EXPECT_EQ(x, solveFractionFree(A, b));
+}
+
+TEST(MultiModularSolverTest, ZeroRightHandSide)
+{
+    MatrixXmpq A(2, 2);
+    A << 2, -1,
+        -1, 2;
+    const std::optional<VectorXmpq> x = solveMultiModular(A, VectorXmpq::Zero(2));
+    ASSERT_TRUE(x);
+    EXPECT_EQ(*x, VectorXmpq::Zero(2));
+}
+
+TEST(MultiModularSolverTest, ZeroLeadingPrincipalMinor)
+{
+    VectorXmpq b(2);
+    b << 1, 2;
+    MatrixXmpq A(2, 2);
+    A << 0, 1,
+         1, 0;
+    EXPECT_FALSE(solveMultiModular(A, b));
+
+    /* Singular, the second leading principal minor vanishes */
+    A << 1, 1,
+         1, 1;
+    EXPECT_FALSE(solveMultiModular(A, b));
+}
+} // namespace fem::ut
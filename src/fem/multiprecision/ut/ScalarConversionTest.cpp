@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+
+#include "fem/multiprecision/ScalarConversion.hpp"
+
+namespace fem::ut
+{
+TEST(ScalarConversionTest, ConvertRational)
+{
+    EXPECT_EQ(convertRational<mpq_class>(mpq_class("-3/7")), mpq_class("-3/7"));
+    EXPECT_EQ(convertRational<double>(mpq_class("1/4")), 0.25);
+    EXPECT_EQ(convertRational<double>(mpq_class("1/3")), 1.0 / 3.0);
+    EXPECT_EQ(convertRational<long double>(mpq_class("1/3")), 1.0L / 3.0L);
+    EXPECT_EQ(convertRational<long double>(mpq_class("-2/7")), -2.0L / 7.0L);
+    const mpf_class third = convertRational<mpf_class>(mpq_class("1/3"));
+    EXPECT_LT(abs(third - mpf_class(1) / 3), mpf_class("1e-18"));
+}
+
+namespace
+{
+template<typename Float>
+void expectRoundedToNearest()
+{
+    constexpr int digits = std::numeric_limits<Float>::digits;
+    const mpq_class ulp = mpq_class(1) / (mpz_class(1) << (digits - 1));
+    const Float one = 1;
+    const Float oneUp = std::nextafter(one, Float(2));
+    /* Just above half an ulp rounds up, exactly half an ulp rounds to the even neighbour */
+    const mpq_class aboveHalf = 1 + ulp / 2 + mpq_class(1) / (mpz_class(1) << 200);
+    EXPECT_EQ(convertRational<Float>(aboveHalf), oneUp);
+    EXPECT_EQ(convertRational<Float>(-aboveHalf), -oneUp);
+    EXPECT_EQ(convertRational<Float>(1 + ulp / 2), one);
+    EXPECT_EQ(convertRational<Float>(1 + 3 * ulp / 2), std::nextafter(oneUp, Float(2)));
+    EXPECT_EQ(convertRational<Float>(1 + ulp / 2 - mpq_class(1) / (mpz_class(1) << 200)), one);
+    /* Rounding up to the next power of two */
+    EXPECT_EQ(convertRational<Float>(2 - ulp / 4), Float(2));
+    EXPECT_EQ(convertRational<Float>(mpq_class(0)), Float(0));
+}
+} // namespace
+
+TEST(ScalarConversionTest, DoubleIsCorrectlyRounded)
+{
+    expectRoundedToNearest<double>();
+    /* The nearest double to 1/10 is above it, get_d truncates to the one below */
+    const mpq_class x = mpq_class(1) / 10;
+    EXPECT_EQ(convertRational<double>(x), 0.1);
+    EXPECT_NE(convertRational<double>(x), x.get_d());
+}
+
+TEST(ScalarConversionTest, LongDoubleIsCorrectlyRounded)
+{
+    expectRoundedToNearest<long double>();
+}
+
+TEST(ScalarConversionTest, ConvertToRational)
+{
+    EXPECT_EQ(convertToRational(mpq_class("5/6")), mpq_class("5/6"));
+    EXPECT_EQ(convertToRational(0.375), mpq_class("3/8"));
+    EXPECT_EQ(convertToRational(-1.5L), mpq_class("-3/2"));
+    EXPECT_EQ(convertToRational(mpf_class("0.25")), mpq_class("1/4"));
+    const long double x = 1.0L / 3.0L;
+    EXPECT_EQ(convertRational<long double>(convertToRational(x)), x);
+    EXPECT_NE(convertToRational(x), convertToRational(static_cast<double>(x)));
+}
+} // namespace fem::ut